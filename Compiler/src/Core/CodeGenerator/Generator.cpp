@@ -1,38 +1,28 @@
 #include "Generator.h"
 #include "Errors/ErrorHandler.h" 
 #include "Data/Nodes.h"
-#include "Data/SymbolTables.h"
 
 
-Ref<ASTNode> Generator::m_AST;
-std::string Generator::m_OutputfilePath;
-
-Generator::Generator(std::shared_ptr<ErrorHandler> errorHandler)
-	: m_ErrorHandler(errorHandler), m_Instigator(EErrorInstigator::CodeGenerator)
+Generator::Generator(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler)
+	: m_Context(context), m_ErrorHandler(errorHandler), m_Instigator(EErrorInstigator::CodeGenerator)
 {
 
 }
 
-void Generator::SetInOut(Ref<ASTNode> ast, const std::string& filePath)
-{
-	m_AST = ast;
-	m_OutputfilePath = filePath;
-}
-
 void Generator::Generate()
 {
-	m_Outputfile.open(m_OutputfilePath, std::ios::out);
+	m_Outputfile.open(m_Context->OutputFilePath, std::ios::out);
 	if (!m_Outputfile.is_open())
 	{
-		auto error = ErrorHandler::CreateGeneralError(std::string("Can't open file for write: ") + m_OutputfilePath, EErrorInstigator::FileIO);
+		auto error = ErrorHandler::CreateGeneralError(std::string("Can't open file for write: ") + m_Context->OutputFilePath, EErrorInstigator::FileIO);
 		m_ErrorHandler->ReportError(error);
 		m_ErrorHandler->GotFatalError();
 		return;
 	}
 
-	Ref<NSignalProgram> program = static_pointer_cast<NSignalProgram>(m_AST);
+	Ref<NSignalProgram> program = static_cast<NSignalProgram*>(m_Context->AST);
 	if (program)
-		SafeAccept(static_pointer_cast<NSignalProgram>(m_AST));
+		SafeAccept(program);
 
 	m_Outputfile.close();
 }
@@ -79,8 +69,8 @@ void Generator::Visit(NVariableDeclarations& node)
 
 void Generator::Visit(NDeclarationsList& node)
 {
-	SafeAccept(node.Decl);
-	SafeAccept(node.DeclList);
+	for (Ref<ASTNode> decl : node.Decls)
+		SafeAccept(decl);
 }
 
 void Generator::Visit(NDeclaration& node)
@@ -100,17 +90,6 @@ void Generator::Visit(NStmt& node)
 
 }
 
-void Generator::Visit(NStmtsList& node)
-{
-	SafeAccept(node.Stmt);
-	SafeAccept(node.StmtsList);
-}
-
-void Generator::Visit(NIfStmt& node)
-{
-	SafeAccept(node.CondStmt);
-}
-
 void Generator::Visit(NAssignStmt& node)
 {
 	m_Reg = "eax";
@@ -122,29 +101,31 @@ void Generator::Visit(NAssignStmt& node)
 
 }
 
-void Generator::Visit(NConditionStmt& node)
+void Generator::EnterConditionStmt(NConditionStmt& node)
 {
-	uint32_t label = m_LabelCounter;
-
-	SafeAccept(node.IncompleteCondStmt);
-	EmitLabel(label);
+	m_ConditionLabels.push_back(m_LabelCounter);
+}
 
-	SafeAccept(node.AltPart);
-	EmitLabel(++label);
+void Generator::LeaveConditionStmt(NConditionStmt& node)
+{
+	EmitLabel(m_ConditionLabels.back() + 1);
+	m_ConditionLabels.pop_back();
 }
 
-void Generator::Visit(NIncompleteConditionStmt& node)
+void Generator::EnterIncompleteConditionStmt(NIncompleteConditionStmt& node)
 {
 	SafeAccept(node.CondExpr);
 	EmitJump("jne", m_LabelCounter++);
+}
 
-	SafeAccept(node.StmtsList);
+void Generator::LeaveIncompleteConditionStmt(NIncompleteConditionStmt& node)
+{
 	EmitJump("jmp", m_LabelCounter++);
 }
 
-void Generator::Visit(NAlternativePart& node)
+void Generator::EnterAlternativePart(NAlternativePart& node)
 {
-	SafeAccept(node.StmtsList);
+	EmitLabel(m_ConditionLabels.back());
 }
 
 void Generator::Visit(NConditionalExpr& node)
@@ -176,12 +157,15 @@ void Generator::Visit(NProcedureIdentifier& node)
 
 void Generator::Visit(NIdentifier& node)
 {
-	m_LastIdentifier = Reverse_IdentifiersTable[node.Identifier];
+	if (node.Identifier < m_Context->Identifiers.Size())
+		m_LastIdentifier = m_Context->Identifiers.Get(node.Identifier);
+	else
+		m_LastIdentifier.clear();
 }
 
 void Generator::Visit(NConstant& node)
 {
-	m_LastConstant = Reverse_ConstantsTable[node.Val];
+	m_LastConstant = node.Val < m_Context->Constants.Size() ? m_Context->Constants.Get(node.Val) : 0;
 }
 
 void Generator::Emit(const std::string& str)
@@ -225,10 +209,10 @@ void Generator::EmitCommandRegToVar(const std::string& command, const std::strin
 }
 
 
-void Generator::EmitCommandConst(const std::string& command, const std::string& value)
+void Generator::EmitCommandConst(const std::string& command, uint64_t value)
 {
 	std::string line;
-	line = "\t" + command + " " + m_Reg + ", " + value;
+	line = "\t" + command + " " + m_Reg + ", " + std::to_string(value);
 	Emit(line);
 }
 
@@ -239,16 +223,17 @@ void Generator::EmitJump(const std::string& jump, uint32_t label)
 	Emit(line);
 }
 
-Error Generator::CreateSemanticError(const std::string& errorMessage, const Token& token)
+Error Generator::CreateSemanticError(const std::string& errorMessage, uint32_t token)
 {
-	return ErrorHandler::CreateSemanticError(errorMessage, token, m_Instigator);
+	SourceLocation location = m_Context->Tokens->Location(token);
+	return ErrorHandler::CreateSemanticError(errorMessage, static_cast<uint32_t>(location.Line), static_cast<uint32_t>(location.Position), m_Instigator);
 }
 
 void Generator::GenExprMov(Ref<ASTNode> node)
 {
-	if (Ref<NVariableIdentifier> variable =  dynamic_pointer_cast<NVariableIdentifier>(node); variable)
+	if (Ref<NVariableIdentifier> variable =  dynamic_cast<NVariableIdentifier*>(node); variable)
 	{
-		CheckIfDeclared(m_LastIdentifier, static_pointer_cast<NIdentifier>(variable->Identifier)->token);
+		CheckIfDeclared(m_LastIdentifier, static_cast<NIdentifier*>(variable->Identifier)->TokenIndex);
 		EmitCommandVarToReg("mov", m_LastIdentifier);
 	}
 	else
@@ -257,7 +242,7 @@ void Generator::GenExprMov(Ref<ASTNode> node)
 	}
 }
 
-void Generator::CheckIfDeclared(const std::string& ident, const Token& token)
+void Generator::CheckIfDeclared(const std::string& ident, uint32_t token)
 {
 	auto it = m_Variables.find(ident);
 	if (it == m_Variables.end())
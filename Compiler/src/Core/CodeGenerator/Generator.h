@@ -1,21 +1,24 @@
 #pragma once
-#include "Data/Visitor.h"
+#include "Data/StatementWalker.h"
 #include "Errors/Error.h"
+#include "Data/CompilationContext.h"
 
 #include <fstream>
 #include <string>
 #include <unordered_set>
+#include <vector>
+#include <cstdint>
 
-#define SafeAccept(expr) do { if (IsValid(expr.get())) { (expr)->Accept(*this); } } while (false)
+#define SafeAccept(expr) do { if (IsValid(expr)) { (expr)->Accept(*this); } } while (false)
 #define VISIT(type) virtual void Visit(type node)
 
 class ErrorHandler;
 
-class Generator : public AST::Visitor
+class Generator : public AST::StatementWalker
 {
 public:
-	Generator(std::shared_ptr<ErrorHandler> errorHandler);
-	static void SetInOut(Ref<ASTNode> ast, const std::string& filePath);
+	// Writes the context's AST as assembly to its OutputFilePath
+	Generator(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler);
 	void Generate();
 
 	VISIT(NSignalProgram&);
@@ -26,12 +29,7 @@ public:
 	VISIT(NDeclaration&);
 	VISIT(NAttribute&);
 	VISIT(NStmt&);
-	VISIT(NStmtsList&);
-	VISIT(NIfStmt&);
 	VISIT(NAssignStmt&);
-	VISIT(NConditionStmt&);
-	VISIT(NIncompleteConditionStmt&);
-	VISIT(NAlternativePart&);
 	VISIT(NConditionalExpr&);
 	VISIT(NExpr&);
 	VISIT(NVariableIdentifier&);
@@ -39,6 +37,12 @@ public:
 	VISIT(NIdentifier&);
 	VISIT(NConstant&);
 
+protected:
+	virtual void EnterConditionStmt(NConditionStmt& node) override;
+	virtual void LeaveConditionStmt(NConditionStmt& node) override;
+	virtual void EnterIncompleteConditionStmt(NIncompleteConditionStmt& node) override;
+	virtual void LeaveIncompleteConditionStmt(NIncompleteConditionStmt& node) override;
+	virtual void EnterAlternativePart(NAlternativePart& node) override;
 
 private:
 	void Emit(const std::string& str);
@@ -48,16 +52,15 @@ private:
 	void EmitCommand(const std::string& command, const std::string& reg1, const std::string& reg2);
 	void EmitCommandVarToReg(const std::string& command, const std::string& variable);
 	void EmitCommandRegToVar(const std::string& command, const std::string& variable);
-	void EmitCommandConst(const std::string& command, const std::string& value);
+	void EmitCommandConst(const std::string& command, uint64_t value);
 	void EmitJump(const std::string& jump, uint32_t label);
-	Error CreateSemanticError(const std::string& errorMessage, const Token& token);
+	Error CreateSemanticError(const std::string& errorMessage, uint32_t token);
 
 	void GenExprMov(Ref<ASTNode> node);
-	void CheckIfDeclared(const std::string& ident, const Token& token);
+	void CheckIfDeclared(const std::string& ident, uint32_t token);
 
 private:
-	static Ref<ASTNode> m_AST;
-	static std::string m_OutputfilePath;
+	std::shared_ptr<CompilationContext> m_Context;
 	std::fstream m_Outputfile;
 
 	std::shared_ptr<ErrorHandler> m_ErrorHandler;
@@ -65,10 +68,11 @@ private:
 
 private:	// States
 	std::string	m_LastIdentifier;
-	std::string m_LastConstant;
+	uint64_t m_LastConstant = 0;
 	std::string m_ProcedureIdentifier;
 	std::string m_Reg = "eax";
 	uint32_t m_LabelCounter = 0;
+	std::vector<uint32_t> m_ConditionLabels;	// Of the IF statements being generated
 
 	std::unordered_set<std::string> m_Variables;
 
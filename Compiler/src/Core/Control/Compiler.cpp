@@ -1,43 +1,231 @@
 #include "Compiler.h"
 #include "Errors/ErrorHandler.h"
+#include "Data/ASTImage.h"
+#include "Parser/IncrementalParser.h"
+#include "Utilities/Hash.h"
 #include "Utilities/Log.h"
 
+#include <fstream>
+
 #include <windows.h>
 
 Compiler::Compiler(std::shared_ptr<ErrorHandler> errorHandler) : m_ErrorHandler(errorHandler)
 {
-	m_TokenSequence = std::make_shared<std::vector<Token>>();
-	m_Lexer = std::make_unique<Lexer>(m_TokenSequence, errorHandler);
-	m_Parser = std::make_unique<Parser>(m_TokenSequence, errorHandler);
-	m_Generator = std::make_unique<Generator>(errorHandler);
+	m_Context = std::make_shared<CompilationContext>();
+	m_Lexer = std::make_unique<Lexer>(m_Context, errorHandler);
+	m_Parser = std::make_unique<Parser>(m_Context, errorHandler);
+	m_Generator = std::make_unique<Generator>(m_Context, errorHandler);
 }
 
 void Compiler::Compile(const std::string& inputfilePath, const std::string& outputfilePath)
+{
+	if (!m_EditScriptPath.empty())
+	{
+		LexAndParseEdited(inputfilePath);
+		if (m_ErrorHandler->HasFatalError())
+			return;
+	}
+	else if (!LoadASTImage(inputfilePath))
+	{
+		if (m_StreamingWindow > 0)
+			LexAndParseStreaming(inputfilePath);
+		else
+			LexAndParse(inputfilePath);
+		if (m_ErrorHandler->HasFatalError())
+			return;
+		SaveASTImage();
+	}
+
+	m_Context->OutputFilePath = outputfilePath;
+	m_Generator->Generate();
+}
+
+void Compiler::SetStreamingWindow(uint32_t windowTokens)
+{
+	m_StreamingWindow = windowTokens;
+}
+
+void Compiler::SetLexerEngine(ELexerEngine engine)
+{
+	m_LexerEngine = engine;
+	m_Lexer->SetEngine(engine);
+}
+
+void Compiler::SetThreadCount(uint32_t threadCount)
+{
+	m_ThreadCount = threadCount;
+}
+
+void Compiler::SetASTImagePath(const std::string& imagePath)
+{
+	m_ASTImagePath = imagePath;
+}
+
+void Compiler::SetEditScriptPath(const std::string& scriptPath)
+{
+	m_EditScriptPath = scriptPath;
+}
+
+void Compiler::LexAndParse(const std::string& inputfilePath)
 {
 	if (m_ErrorHandler->HasFatalError())
 		return;
-	m_Lexer->Scan(inputfilePath);
+	m_Lexer->Scan(inputfilePath, m_ThreadCount);
 
 	if (m_ErrorHandler->HasFatalError())
 		return;
+	m_Parser->Parse(m_ThreadCount);
+}
+
+void Compiler::LexAndParseStreaming(const std::string& inputfilePath)
+{
+	if (m_ErrorHandler->HasFatalError())
+		return;
+	if (!m_Lexer->Open(inputfilePath))
+		return;
+
+	m_Parser->SetTokenSource(m_Lexer.get(), m_StreamingWindow);
 	m_Parser->Parse();
+	m_Parser->SetTokenSource(nullptr, 0);
 
-	m_AST = m_Parser->GetAST();
-	Generator::SetInOut(m_AST, outputfilePath);
+	// The parser can stop early, the rest still has to be lexed for its errors
+	while (m_Lexer->ScanNext(m_StreamingWindow))
+		m_Context->Tokens->Compact(m_Context->Tokens->Size() - 1);
 
+	// A source that turned out too large ends the lexer early, what the parser made of that doesn't count
 	if (m_ErrorHandler->HasFatalError())
+		std::erase_if(*m_ErrorHandler->GetErrors(), [](const Error& error) { return error.GetEnumInstigator() == EErrorInstigator::Parser; });
+
+	// Report lexer errors ahead of parser errors, as if the whole file had been lexed first
+	m_ErrorHandler->SortByInstigator();
+}
+
+void Compiler::LexAndParseEdited(const std::string& inputfilePath)
+{
+	std::vector<TextEdit> edits;
+	if (m_ErrorHandler->HasFatalError() || !ReadEditScript(edits))
 		return;
-	m_Generator->Generate();
+
+	IncrementalLexer lexer(m_Context, m_ErrorHandler);
+	lexer.SetEngine(m_LexerEngine);
+	if (!lexer.Open(inputfilePath))
+		return;
+
+	// Only the errors of the text the script leaves count, parser errors of the text in between are dropped
+	auto parserErrors = std::make_shared<ErrorHandler>();
+	IncrementalParser parser(m_Context, parserErrors);
+	parser.Parse();
+	for (const TextEdit& edit : edits)
+	{
+		lexer.Relex({ edit });
+		parserErrors->GetErrors()->clear();
+		parser.Reparse(lexer.LastDamage());
+	}
+	parser.SettleLeaves();
+
+	// Lexer errors ahead of parser errors, as if the text had been compiled from scratch
+	lexer.ReportErrors();
+	for (const Error& error : *parserErrors->GetErrors())
+		m_ErrorHandler->ReportError(error);
+}
+
+// One edit per line: <offset> <removed length> <inserted text>, where \n, \t and \\ stand for a newline,
+// a tab and a backslash. Offsets are into the text as the edits before left it. Empty lines and lines starting with # are skipped
+bool Compiler::ReadEditScript(std::vector<TextEdit>& edits)
+{
+	std::ifstream script(m_EditScriptPath);
+	if (!script)
+	{
+		auto error = ErrorHandler::CreateGeneralError(std::string("No such file or directory: ") + m_EditScriptPath, EErrorInstigator::FileIO);
+		m_ErrorHandler->ReportError(error);
+		m_ErrorHandler->GotFatalError();
+		return false;
+	}
+
+	std::string line;
+	for (uint32_t lineNumber = 1; std::getline(script, line); lineNumber++)
+	{
+		if (!line.empty() && line.back() == '\r')
+			line.pop_back();
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		const char* cursor = line.c_str();
+		char* end = nullptr;
+		TextEdit edit{};
+		edit.Offset = static_cast<uint32_t>(std::strtoul(cursor, &end, 10));
+		bool bValid = end != cursor && *end == ' ';
+		if (bValid)
+		{
+			cursor = end + 1;
+			edit.RemovedLength = static_cast<uint32_t>(std::strtoul(cursor, &end, 10));
+			bValid = end != cursor && (*end == ' ' || *end == '\0');
+		}
+		for (const char* c = *end == ' ' ? end + 1 : end; bValid && *c != '\0'; c++)
+		{
+			if (*c != '\\')
+			{
+				edit.Inserted += *c;
+				continue;
+			}
+			switch (*++c)
+			{
+			case 'n':	edit.Inserted += '\n'; break;
+			case 't':	edit.Inserted += '\t'; break;
+			case '\\':	edit.Inserted += '\\'; break;
+			default:	bValid = false; break;
+			}
+		}
+
+		if (!bValid)
+		{
+			auto error = ErrorHandler::CreateGeneralError("Malformed edit on line " + std::to_string(lineNumber) + " of " + m_EditScriptPath, EErrorInstigator::FileIO);
+			m_ErrorHandler->ReportError(error);
+			m_ErrorHandler->GotFatalError();
+			return false;
+		}
+		edits.push_back(std::move(edit));
+	}
+	return true;
 }
 
-std::shared_ptr<LexerData> Compiler::GetLexerData()
+// Takes the tree and the symbol tables from the image if it was made from this very source
+bool Compiler::LoadASTImage(const std::string& inputfilePath)
 {
-	return m_Lexer->GetLexerData();
+	if (m_ASTImagePath.empty() || m_ErrorHandler->HasFatalError())
+		return false;
+
+	auto source = std::make_shared<SourceBuffer>();
+	if (!source->Open(inputfilePath))
+		return false;
+	m_SourceHash = HashBytes(source->Begin(), source->Size());
+
+	ASTImage image;
+	if (!image.Open(m_ASTImagePath, m_SourceHash))
+		return false;
+	image.LoadSymbols(m_Context->Identifiers, m_Context->Constants);
+	m_Context->Nodes.Clear();
+	m_Context->AST = image.Tree().Inflate(m_Context->Nodes);
+	// Nothing is lexed, the leaves are located through the source alone
+	m_Context->Tokens->SetSource(source);
+	image.Tree().PinLeafTokens(*m_Context->Tokens);
+	return true;
+}
+
+// Only a clean parse is kept, a rebuild has to report the errors again
+void Compiler::SaveASTImage()
+{
+	if (m_ASTImagePath.empty() || !m_ErrorHandler->GetErrors()->empty())
+		return;
+
+	FlatAST tree;
+	tree.Build(m_Context->AST, *m_Context->Tokens);
+	ASTImage::Write(m_ASTImagePath, m_SourceHash, tree, m_Context->Identifiers, m_Context->Constants);
 }
 
-Ref<ASTNode> Compiler::GetAST()
+std::shared_ptr<const CompilationContext> Compiler::GetContext() const
 {
-	return m_AST;
+	return m_Context;
 }
 
 bool Compiler::Assemble(const std::string& filePath)
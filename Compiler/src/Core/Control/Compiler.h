@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Lexer/Lexer.h"
+#include "Lexer/IncrementalLexer.h"
 #include "Parser/Parser.h"
 #include "CodeGenerator/Generator.h"
 
@@ -9,19 +10,33 @@
 #include <memory>
 
 class ErrorHandler;
-struct Token;
 
 class Compiler 
 {
 public:
 	Compiler(std::shared_ptr<ErrorHandler> errorHandler);
 	void Compile(const std::string& inputfilePath, const std::string& outputfilePath);
-
-	std::shared_ptr<LexerData> GetLexerData();
-	Ref<ASTNode> GetAST();
+	// Lex while parsing instead of up front, with at most about 'windowTokens' tokens held at a time. 0 turns it off
+	void SetStreamingWindow(uint32_t windowTokens);
+	void SetLexerEngine(ELexerEngine engine);
+	// Threads the lexer and parser may use for large sources
+	void SetThreadCount(uint32_t threadCount);
+	// Reuse the tree parsed into the ASTImage at 'imagePath' while the source is unchanged, and keep it there. Empty turns it off
+	void SetASTImagePath(const std::string& imagePath);
+	// Open the source the way an editor would and apply the edits in the script at 'scriptPath' one at a time,
+	// relexing and reparsing incrementally, then compile what they leave. Empty turns it off
+	void SetEditScriptPath(const std::string& scriptPath);
+
+	std::shared_ptr<const CompilationContext> GetContext() const;
 	bool Assemble(const std::string& filePath);
 	bool Link(const std::string& filePath);
 private:
+	void LexAndParse(const std::string& inputfilePath);
+	void LexAndParseStreaming(const std::string& inputfilePath);
+	void LexAndParseEdited(const std::string& inputfilePath);
+	bool ReadEditScript(std::vector<TextEdit>& edits);
+	bool LoadASTImage(const std::string& inputfilePath);
+	void SaveASTImage();
 	bool ExecuteCommand(const std::string& command, std::string& output);
 
 private:
@@ -30,7 +45,12 @@ private:
 	std::unique_ptr<Generator> m_Generator;
 	std::shared_ptr<ErrorHandler> m_ErrorHandler;
 
-	std::shared_ptr<std::vector<Token>>	 m_TokenSequence;
-	Ref<ASTNode> m_AST;
+	std::shared_ptr<CompilationContext> m_Context;
+	uint32_t m_StreamingWindow = 0;
+	uint32_t m_ThreadCount = 1;
+	ELexerEngine m_LexerEngine = ELexerEngine::StateMachine;
+	std::string m_ASTImagePath;
+	uint64_t m_SourceHash = 0;
+	std::string m_EditScriptPath;
 
 };
@@ -5,10 +5,15 @@
 #include "Utilities/Log.h"
 #include "Parser/PrintVisitor.h"
 #include "Utilities/Timer.h"
+#include "Utilities/ThreadPool.h"
 
 #include <cstdlib>
 #include <filesystem>
 
+static constexpr uint32_t s_StreamingWindow = 4096;
+static constexpr const char* s_StdinSource = "-";
+static constexpr const char* s_StdinOutputName = "stdin";
+
 Driver::Driver()
 {
 	m_ErrorHandler = std::make_shared<ErrorHandler>();
@@ -39,7 +44,7 @@ bool Driver::CreateOptionsFromCLArguments(int argc, char* argv[])
 		bool gotSource = false;
 		for (int i = 1; i < argc; i++)
 		{
-			if (std::string(argv[i])[0] != '-')
+			if (std::string(argv[i])[0] != '-' || std::string(argv[i]) == s_StdinSource)
 			{
 				if (gotSource)
 					continue;
@@ -59,6 +64,28 @@ bool Driver::CreateOptionsFromCLArguments(int argc, char* argv[])
 			{
 				m_Options.Verbose = true;
 			}
+			else if (std::string(argv[i]) == "-stream")
+			{
+				m_Options.Streaming = true;
+			}
+			else if (std::string(argv[i]) == "-dfa")
+			{
+				m_Options.TableLexer = true;
+			}
+			else if (std::string(argv[i]) == "-cache")
+			{
+				m_Options.CacheAST = true;
+			}
+			else if (std::string(argv[i]) == "-edits")
+			{
+				if (i != argc - 1)
+					m_Options.EditScript = argv[++i];
+			}
+			else if (std::string(argv[i]) == "-j")
+			{
+				if (i != argc - 1)
+					m_Options.Threads = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+			}
 			else if (std::string(argv[i]) == "-h" || std::string(argv[i]) == "-help")
 			{
 				m_UI->UsageHint();
@@ -68,7 +95,7 @@ bool Driver::CreateOptionsFromCLArguments(int argc, char* argv[])
 	}
 	if (m_Options.OutputFile.empty())
 	{
-		std::filesystem::path sourcePath(m_Options.SourceFile);
+		std::filesystem::path sourcePath(m_Options.SourceFile == s_StdinSource ? s_StdinOutputName : m_Options.SourceFile);
 		if (m_Options.ListingOnly)
 			m_Options.OutputFile = sourcePath.filename().replace_extension(".s").string();
 		else
@@ -168,12 +195,20 @@ void Driver::Start()
 	if (!m_Options.ListingOnly)
 		outPath.replace_extension(".asm");
 
+	if (m_Options.Streaming)
+		m_Compiler->SetStreamingWindow(s_StreamingWindow);
+	m_Compiler->SetThreadCount(m_Options.Threads > 0 ? m_Options.Threads : ThreadPool::DefaultThreadCount());
+	m_Compiler->SetLexerEngine(m_Options.TableLexer ? ELexerEngine::Table : ELexerEngine::StateMachine);
+	m_Compiler->SetEditScriptPath(m_Options.EditScript);
+	// A tree from the cache comes without tokens, which verbose output lists
+	if (m_Options.CacheAST && m_Options.EditScript.empty() && !m_Options.Streaming && !m_Options.Verbose && m_Options.SourceFile != s_StdinSource)
+		m_Compiler->SetASTImagePath(std::filesystem::path(outPath).replace_extension(".ast").string());
 	m_Compiler->Compile(m_Options.SourceFile, outPath.string());
 	bool success = !m_ErrorHandler->HasFatalError();
 	if (success)
 		success &= Assemble();
 
-	m_UI->SetLexerData(m_Compiler->GetLexerData());
+	m_UI->SetContext(m_Compiler->GetContext());
 	m_UI->OutErrors();
 
 	if (m_ErrorHandler->HasFatalError())
@@ -185,8 +220,8 @@ void Driver::Start()
 	{
 		m_UI->OutOptions(m_Options.SourceFile, m_Options.OutputFile);
 		m_UI->OutLexerResult();
-		AST::PrintVisitor printer;
-		m_UI->OutAST(printer.Print(m_Compiler->GetAST()));
+		AST::PrintVisitor printer(m_Compiler->GetContext());
+		m_UI->OutAST(printer.Print(m_Compiler->GetContext()->AST));
 	}
 
 	if (success)
@@ -15,6 +15,11 @@ struct Options
 	std::string OutputFile;
 	bool ListingOnly = false;
 	bool Verbose = false;
+	bool Streaming = false;
+	uint32_t Threads = 0;	// 0 picks one per hardware thread
+	bool TableLexer = false;
+	bool CacheAST = false;
+	std::string EditScript;
 };
 
 class Driver final
@@ -0,0 +1,191 @@
+#include "ASTImage.h"
+#include "Data/StringInterner.h"
+#include "Data/ConstantTable.h"
+#include "Utilities/Hash.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+	constexpr char s_Magic[8] = { 'S', 'S', 'C', 'A', 'S', 'T', '\0', '\0' };
+
+	struct ImageHeader
+	{
+		char Magic[8];
+		uint32_t Version;
+		uint32_t NodeSize;
+		uint64_t SourceHash;
+		uint64_t Checksum;		// Of everything after the header
+		uint32_t NodeCount;
+		uint32_t ConstantCount;
+		uint32_t ItemCount;
+		uint32_t IdentifierCount;
+		uint32_t IdentifierTextSize;
+		uint32_t Reserved;
+	};
+	static_assert(sizeof(ImageHeader) % alignof(uint64_t) == 0, "Sections after the header must stay aligned");
+
+	uint64_t ImageSize(const ImageHeader& header)
+	{
+		return sizeof(ImageHeader)
+			+ static_cast<uint64_t>(header.NodeCount) * sizeof(FlatNode)
+			+ static_cast<uint64_t>(header.ConstantCount) * sizeof(uint64_t)
+			+ static_cast<uint64_t>(header.ItemCount) * sizeof(uint32_t)
+			+ static_cast<uint64_t>(header.IdentifierCount) * sizeof(uint32_t)
+			+ header.IdentifierTextSize;
+	}
+
+	template<typename T>
+	void Append(std::vector<char>& out, const T* items, size_t count)
+	{
+		const char* bytes = reinterpret_cast<const char*>(items);
+		out.insert(out.end(), bytes, bytes + count * sizeof(T));
+	}
+}
+
+bool ASTImage::Write(const std::string& filePath, uint64_t sourceHash, const FlatAST& tree,
+	const StringInterner& identifiers, const ConstantTable& constants)
+{
+	std::vector<uint64_t> constantValues;
+	constantValues.reserve(constants.Size());
+	for (uint32_t id = 0; id < constants.Size(); id++)
+		constantValues.push_back(constants.Get(id));
+
+	std::vector<uint32_t> identifierEnds;
+	std::string identifierText;
+	identifierEnds.reserve(identifiers.Size());
+	for (uint32_t id = 0; id < identifiers.Size(); id++)
+	{
+		identifierText += identifiers.Get(id);
+		identifierEnds.push_back(static_cast<uint32_t>(identifierText.size()));
+	}
+
+	ImageHeader header = {};
+	std::memcpy(header.Magic, s_Magic, sizeof(s_Magic));
+	header.Version = Version;
+	header.NodeSize = sizeof(FlatNode);
+	header.SourceHash = sourceHash;
+	header.NodeCount = tree.Size();
+	header.ConstantCount = static_cast<uint32_t>(constantValues.size());
+	header.ItemCount = static_cast<uint32_t>(tree.Items().size());
+	header.IdentifierCount = static_cast<uint32_t>(identifierEnds.size());
+	header.IdentifierTextSize = static_cast<uint32_t>(identifierText.size());
+
+	std::vector<char> payload;
+	payload.reserve(ImageSize(header) - sizeof(ImageHeader));
+	Append(payload, tree.Nodes().data(), tree.Nodes().size());
+	Append(payload, constantValues.data(), constantValues.size());
+	Append(payload, tree.Items().data(), tree.Items().size());
+	Append(payload, identifierEnds.data(), identifierEnds.size());
+	Append(payload, identifierText.data(), identifierText.size());
+	header.Checksum = HashBytes(payload.data(), payload.size());
+
+	std::ofstream file(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(payload.data(), payload.size());
+	return file.good();
+}
+
+bool ASTImage::Open(const std::string& filePath, uint64_t sourceHash)
+{
+	Close();
+	if (!m_File.Open(filePath) || m_File.Size() < sizeof(ImageHeader))
+	{
+		Close();
+		return false;
+	}
+
+	ImageHeader header;
+	std::memcpy(&header, m_File.Begin(), sizeof(header));
+	const char* payload = m_File.Begin() + sizeof(ImageHeader);
+	bool bValid = std::memcmp(header.Magic, s_Magic, sizeof(s_Magic)) == 0
+		&& header.Version == Version
+		&& header.NodeSize == sizeof(FlatNode)
+		&& header.SourceHash == sourceHash
+		&& ImageSize(header) == m_File.Size()
+		&& HashBytes(payload, m_File.Size() - sizeof(ImageHeader)) == header.Checksum;
+	if (!bValid)
+	{
+		Close();
+		return false;
+	}
+
+	// A mapping starts on a page boundary and sections keep the alignment of their type
+	auto nodes = reinterpret_cast<const FlatNode*>(payload);
+	auto constantValues = reinterpret_cast<const uint64_t*>(nodes + header.NodeCount);
+	auto items = reinterpret_cast<const uint32_t*>(constantValues + header.ConstantCount);
+	auto identifierEnds = items + header.ItemCount;
+
+	m_Tree.View({ nodes, header.NodeCount }, { items, header.ItemCount });
+	m_Constants = { constantValues, header.ConstantCount };
+	m_IdentifierEnds = { identifierEnds, header.IdentifierCount };
+	m_IdentifierText = reinterpret_cast<const char*>(identifierEnds + header.IdentifierCount);
+
+	if (!IsWellFormed())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void ASTImage::Close()
+{
+	m_Tree.Clear();
+	m_Constants = {};
+	m_IdentifierEnds = {};
+	m_IdentifierText = nullptr;
+	m_File.Close();
+}
+
+void ASTImage::LoadSymbols(StringInterner& identifiers, ConstantTable& constants) const
+{
+	uint32_t begin = 0;
+	for (uint32_t end : m_IdentifierEnds)
+	{
+		identifiers.Intern(std::string_view(m_IdentifierText + begin, end - begin));
+		begin = end;
+	}
+	for (uint64_t value : m_Constants)
+		constants.Intern(value);
+}
+
+// The checksum catches damage, this catches images that would send Inflate() out of bounds
+bool ASTImage::IsWellFormed() const
+{
+	uint32_t count = m_Tree.Size();
+	auto isChild = [count](uint32_t parent, uint32_t child) { return child == FlatNode::None || (child > parent && child < count); };
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		const FlatNode& node = m_Tree[i];
+		if (node.Kind > ENodeKind::Constant)
+			return false;
+
+		if (node.Kind == ENodeKind::StmtsList || node.Kind == ENodeKind::DeclarationsList)
+		{
+			if (static_cast<uint64_t>(node.Children[0]) + node.Children[1] > m_Tree.Items().size())
+				return false;
+			for (uint32_t item : m_Tree.ListItems(node))
+			{
+				if (!isChild(i, item))
+					return false;
+			}
+		}
+		else if (!isChild(i, node.Children[0]) || !isChild(i, node.Children[1]))
+		{
+			return false;
+		}
+	}
+
+	uint32_t begin = 0;
+	for (uint32_t end : m_IdentifierEnds)
+	{
+		if (end < begin)
+			return false;
+		begin = end;
+	}
+	return m_IdentifierEnds.empty() || m_IdentifierEnds.back() == m_File.Size() - (m_IdentifierText - m_File.Begin());
+}
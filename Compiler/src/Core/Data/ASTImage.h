@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Data/FlatAST.h"
+#include "Data/SourceBuffer.h"
+
+#include <span>
+#include <string>
+#include <cstdint>
+
+class StringInterner;
+class ConstantTable;
+
+// On-disk image of a parsed program: its FlatAST and the symbol tables the tree refers to, in native byte order.
+// A header with a version, the hash of the source it was parsed from and a checksum of the rest comes first,
+// then the node records, constants, list items, identifier ends and identifier text, each section aligned for its type.
+// Opening maps the file and the tree is used where it lies; only the symbol tables are interned again
+class ASTImage
+{
+public:
+	static constexpr uint32_t Version = 2;
+
+	static bool Write(const std::string& filePath, uint64_t sourceHash, const FlatAST& tree,
+		const StringInterner& identifiers, const ConstantTable& constants);
+
+	// False unless the image is intact, of this version and made from source with 'sourceHash'
+	bool Open(const std::string& filePath, uint64_t sourceHash);
+	void Close();
+
+	// Both only valid while the image is open
+	const FlatAST& Tree() const { return m_Tree; }
+	void LoadSymbols(StringInterner& identifiers, ConstantTable& constants) const;
+
+private:
+	bool IsWellFormed() const;
+
+private:
+	SourceBuffer m_File;
+	FlatAST m_Tree;
+	std::span<const uint64_t> m_Constants;
+	std::span<const uint32_t> m_IdentifierEnds;
+	const char* m_IdentifierText = nullptr;
+};
@@ -7,8 +7,11 @@
 #include <list>
 #include <vector>
 
+// Nodes belong to the NodeArena of their compilation, a Ref is a plain pointer into it
 template<typename T>
-using Ref = std::shared_ptr<T>;
+using Ref = T*;
+
+class NodeArena;
 
 namespace AST
 {
@@ -18,14 +21,42 @@ namespace AST
 struct ASTNode 
 {
 public:
-	virtual ~ASTNode() = default;
-	virtual std::vector<Ref<ASTNode>> GetData() = 0;
+	// Child slots in grammar order, a list has one per item. Missing children are nullptr
+	virtual uint32_t ChildCount() const = 0;
+	virtual Ref<ASTNode> Child(uint32_t index) const = 0;	// index < ChildCount()
 	virtual std::string ToString() = 0;
 
 	virtual void Accept(AST::Visitor& visitor) = 0;
 
+protected:
+	// Never deleted through a base pointer, the arena frees nodes without destroying them
+	~ASTNode() = default;
+};
+
+// Children of a list node, stored back to back in the arena
+struct NodeList
+{
+	Ref<ASTNode>* Items = nullptr;
+	uint32_t Count = 0;
+
+	Ref<ASTNode>* begin() const { return Items; }
+	Ref<ASTNode>* end() const { return Items + Count; }
+	Ref<ASTNode> operator[](uint32_t index) const { return Items[index]; }
+	uint32_t Size() const { return Count; }
+	bool Empty() const { return Count == 0; }
 };
 
+namespace AST
+{
+	// Calls 'function' with every child slot of 'node', in order
+	template<typename Function>
+	void ForEachChild(const ASTNode& node, Function&& function)
+	{
+		for (uint32_t i = 0, count = node.ChildCount(); i < count; i++)
+			function(node.Child(i));
+	}
+}
+
 struct NSignalProgram;
 struct NProgram;
 struct NBlock;
@@ -51,23 +82,23 @@ struct NConstant;
 
 namespace AST
 {
-	Ref<ASTNode> MakeSignalProgram(Ref<ASTNode> program);
-	Ref<ASTNode> MakeProgram(ETokenCode program, Ref<ASTNode> procId, ETokenCode sc, Ref<ASTNode> block, ETokenCode dot);
-	Ref<ASTNode> MakeBlock(Ref<ASTNode> varDecl, ETokenCode begin, Ref<ASTNode> stmtList, ETokenCode end);
-	Ref<ASTNode> MakeVariableDeclarations(ETokenCode var, Ref<ASTNode> declList, bool empty = false);
-	Ref<ASTNode> MakeDeclarationsList(Ref<ASTNode> decl, Ref<ASTNode> declList, bool empty = false);
-	Ref<ASTNode> MakeDeclaration(Ref<ASTNode> varId, ETokenCode colon, Ref<ASTNode> atr, ETokenCode sc);
-	Ref<ASTNode> MakeAttribute(ETokenCode type);
-	Ref<ASTNode> MakeStmtsList(Ref<ASTNode> stmt, Ref<ASTNode> stmtsList, bool empty = false);
-	Ref<ASTNode> MakeIfStmt(Ref<ASTNode> condStmt, ETokenCode eif, ETokenCode sc);
-	Ref<ASTNode> MakeAssignStmt(Ref<ASTNode> varId, ETokenCode op, Ref<ASTNode> expr, ETokenCode sc);
-	Ref<ASTNode> MakeConditionStmt(Ref<ASTNode> incCondStmt, Ref<ASTNode> alt);
-	Ref<ASTNode> MakeIncompleteConditionStmt(ETokenCode _if, Ref<ASTNode> condExpr, ETokenCode then, Ref<ASTNode> stmtsList);
-	Ref<ASTNode> MakeAlternativePart(ETokenCode _else, Ref<ASTNode> stmtsList, bool empty = false);
-	Ref<ASTNode> MakeConditionalExpr(Ref<ASTNode> expr1, ETokenCode op, Ref<ASTNode> expr2);
-	Ref<ASTNode> MakeVariableIdentifier(Ref<ASTNode> id);
-	Ref<ASTNode> MakeProcedureIdentifier(Ref<ASTNode> id);
-	Ref<ASTNode> MakeIdentifier(uint32_t id, const Token& tok);
-	Ref<ASTNode> MakeConstant(uint32_t value, const Token& tok);
+	Ref<ASTNode> MakeSignalProgram(NodeArena& arena, Ref<ASTNode> program);
+	Ref<ASTNode> MakeProgram(NodeArena& arena, ETokenCode program, Ref<ASTNode> procId, ETokenCode sc, Ref<ASTNode> block, ETokenCode dot);
+	Ref<ASTNode> MakeBlock(NodeArena& arena, Ref<ASTNode> varDecl, ETokenCode begin, Ref<ASTNode> stmtList, ETokenCode end);
+	Ref<ASTNode> MakeVariableDeclarations(NodeArena& arena, ETokenCode var, Ref<ASTNode> declList, bool empty = false);
+	Ref<ASTNode> MakeDeclarationsList(NodeArena& arena, NodeList decls);
+	Ref<ASTNode> MakeDeclaration(NodeArena& arena, Ref<ASTNode> varId, ETokenCode colon, Ref<ASTNode> atr, ETokenCode sc);
+	Ref<ASTNode> MakeAttribute(NodeArena& arena, ETokenCode type);
+	Ref<ASTNode> MakeStmtsList(NodeArena& arena, NodeList stmts, bool complete = true);
+	Ref<ASTNode> MakeIfStmt(NodeArena& arena, Ref<ASTNode> condStmt, ETokenCode eif, ETokenCode sc);
+	Ref<ASTNode> MakeAssignStmt(NodeArena& arena, Ref<ASTNode> varId, ETokenCode op, Ref<ASTNode> expr, ETokenCode sc);
+	Ref<ASTNode> MakeConditionStmt(NodeArena& arena, Ref<ASTNode> incCondStmt, Ref<ASTNode> alt);
+	Ref<ASTNode> MakeIncompleteConditionStmt(NodeArena& arena, ETokenCode _if, Ref<ASTNode> condExpr, ETokenCode then, Ref<ASTNode> stmtsList);
+	Ref<ASTNode> MakeAlternativePart(NodeArena& arena, ETokenCode _else, Ref<ASTNode> stmtsList, bool empty = false);
+	Ref<ASTNode> MakeConditionalExpr(NodeArena& arena, Ref<ASTNode> expr1, ETokenCode op, Ref<ASTNode> expr2);
+	Ref<ASTNode> MakeVariableIdentifier(NodeArena& arena, Ref<ASTNode> id);
+	Ref<ASTNode> MakeProcedureIdentifier(NodeArena& arena, Ref<ASTNode> id);
+	Ref<ASTNode> MakeIdentifier(NodeArena& arena, uint32_t id, uint32_t token);
+	Ref<ASTNode> MakeConstant(NodeArena& arena, uint32_t value, uint32_t token);
 
 }
\ No newline at end of file
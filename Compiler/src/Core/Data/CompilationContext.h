@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Data/ASTNode.h"
+#include "Data/NodeArena.h"
+#include "Data/SourceBuffer.h"
+#include "Data/TokenStream.h"
+#include "Data/StringInterner.h"
+#include "Data/ConstantTable.h"
+
+#include <memory>
+#include <string>
+
+// Everything one compilation reads and produces, shared by its stages.
+// Nothing here is global, so separate compilations never see each other's state
+struct CompilationContext
+{
+	std::shared_ptr<SourceBuffer> Source;
+	std::shared_ptr<TokenStream> Tokens = std::make_shared<TokenStream>();
+	ConstantTable Constants;
+	StringInterner Identifiers;
+
+	NodeArena Nodes;
+	Ref<ASTNode> AST;		// Made in Nodes
+	std::string OutputFilePath;
+};
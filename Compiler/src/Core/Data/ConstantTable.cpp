@@ -0,0 +1,77 @@
+#include "ConstantTable.h"
+
+static constexpr size_t s_InitialCapacity = 64;
+
+ConstantTable::ConstantTable()
+{
+	Clear();
+}
+
+uint32_t ConstantTable::Intern(uint64_t value)
+{
+	uint32_t hash = Hash(value);
+	size_t slot = FindSlot(value, hash);
+	if (m_Slots[slot].Id != InvalidId)
+		return m_Slots[slot].Id;
+
+	uint32_t id = static_cast<uint32_t>(m_Values.size());
+	m_Values.push_back(value);
+	m_Hashes.push_back(hash);
+	m_Slots[slot] = { hash, id };
+
+	if (m_Values.size() * 2 > m_Slots.size())
+		Grow();
+	return id;
+}
+
+uint32_t ConstantTable::Find(uint64_t value) const
+{
+	return m_Slots[FindSlot(value, Hash(value))].Id;
+}
+
+void ConstantTable::Clear()
+{
+	m_Values.clear();
+	m_Hashes.clear();
+
+	m_Slots.assign(s_InitialCapacity, { 0, InvalidId });
+	m_Mask = s_InitialCapacity - 1;
+}
+
+uint32_t ConstantTable::Hash(uint64_t value)
+{
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDull;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ull;
+	value ^= value >> 33;
+	return static_cast<uint32_t>(value);
+}
+
+size_t ConstantTable::FindSlot(uint64_t value, uint32_t hash) const
+{
+	size_t slot = hash & m_Mask;
+	for (;;)
+	{
+		const Slot& candidate = m_Slots[slot];
+		if (candidate.Id == InvalidId)
+			return slot;
+		if (candidate.Hash == hash && m_Values[candidate.Id] == value)
+			return slot;
+		slot = (slot + 1) & m_Mask;
+	}
+}
+
+void ConstantTable::Grow()
+{
+	m_Slots.assign(m_Slots.size() * 2, { 0, InvalidId });
+	m_Mask = m_Slots.size() - 1;
+
+	for (uint32_t id = 0; id < m_Hashes.size(); id++)
+	{
+		size_t slot = m_Hashes[id] & m_Mask;
+		while (m_Slots[slot].Id != InvalidId)
+			slot = (slot + 1) & m_Mask;
+		m_Slots[slot] = { m_Hashes[id], id };
+	}
+}
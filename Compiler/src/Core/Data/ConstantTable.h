@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Maps integer constant values to dense 32-bit ids in order of first appearance,
+// so constants spelled differently but equal in value ("007" and "7") share an id.
+// Same open-addressed layout as StringInterner, without the arena.
+class ConstantTable
+{
+public:
+	static constexpr uint32_t InvalidId = UINT32_MAX;
+
+	ConstantTable();
+
+	uint32_t Intern(uint64_t value);
+	uint32_t Find(uint64_t value) const;
+	uint64_t Get(uint32_t id) const { return m_Values[id]; }
+
+	size_t Size() const { return m_Values.size(); }
+	bool Empty() const { return m_Values.empty(); }
+	void Clear();
+
+	static uint32_t Hash(uint64_t value);
+
+private:
+	struct Slot
+	{
+		uint32_t Hash;
+		uint32_t Id;
+	};
+
+	size_t FindSlot(uint64_t value, uint32_t hash) const;
+	void Grow();
+
+private:
+	std::vector<uint64_t> m_Values;
+	std::vector<uint32_t> m_Hashes;
+
+	std::vector<Slot> m_Slots;
+	size_t m_Mask;
+};
@@ -0,0 +1,267 @@
+#include "FlatAST.h"
+#include "Data/Nodes.h"
+#include "Data/NodeArena.h"
+#include "Data/Visitor.h"
+#include "Data/TokenStream.h"
+
+#include <initializer_list>
+
+namespace
+{
+	// Adds the record of every node it visits and schedules the children instead of visiting them,
+	// so the tree is flattened from a heap stack in pre-order
+	class FlatASTBuilder : public AST::Visitor
+	{
+	public:
+		FlatASTBuilder(std::vector<FlatNode>& nodes, std::vector<uint32_t>& items, const TokenStream& tokens)
+			: m_Nodes(nodes), m_Items(items), m_Tokens(tokens) {}
+
+		void Build(Ref<ASTNode> root)
+		{
+			m_Pending.push_back({ root, FlatNode::None, 0 });
+			while (!m_Pending.empty())
+			{
+				m_Current = m_Pending.back();
+				m_Pending.pop_back();
+				m_Current.Node->Accept(*this);
+			}
+		}
+
+		virtual void Visit(NSignalProgram& node) override
+		{
+			Schedule(Add(ENodeKind::SignalProgram, {}), node);
+		}
+
+		virtual void Visit(NProgram& node) override
+		{
+			Schedule(Add(ENodeKind::Program, { +node.Program, +node.Semicolon, +node.Dot }), node);
+		}
+
+		virtual void Visit(NBlock& node) override
+		{
+			Schedule(Add(ENodeKind::Block, { +node.Begin, +node.End }), node);
+		}
+
+		virtual void Visit(NVariableDeclarations& node) override
+		{
+			Schedule(Add(ENodeKind::VariableDeclarations, { +node.Var }, node.Empty), node);
+		}
+
+		virtual void Visit(NDeclarationsList& node) override
+		{
+			ScheduleList(Add(ENodeKind::DeclarationsList, {}), node);
+		}
+
+		virtual void Visit(NDeclaration& node) override
+		{
+			Schedule(Add(ENodeKind::Declaration, { +node.Colon, +node.Semicolon }), node);
+		}
+
+		virtual void Visit(NAttribute& node) override
+		{
+			Add(ENodeKind::Attribute, { +node.Type });
+		}
+
+		virtual void Visit(NStmt& node) override {}
+
+		virtual void Visit(NStmtsList& node) override
+		{
+			ScheduleList(Add(ENodeKind::StmtsList, {}, node.Complete), node);
+		}
+
+		virtual void Visit(NIfStmt& node) override
+		{
+			Schedule(Add(ENodeKind::IfStmt, { +node.Endif, +node.Semicolon }), node);
+		}
+
+		virtual void Visit(NAssignStmt& node) override
+		{
+			Schedule(Add(ENodeKind::AssignStmt, { +node.Op, +node.Semicolon }), node);
+		}
+
+		virtual void Visit(NConditionStmt& node) override
+		{
+			Schedule(Add(ENodeKind::ConditionStmt, {}), node);
+		}
+
+		virtual void Visit(NIncompleteConditionStmt& node) override
+		{
+			Schedule(Add(ENodeKind::IncompleteConditionStmt, { +node.If, +node.Then }), node);
+		}
+
+		virtual void Visit(NAlternativePart& node) override
+		{
+			Schedule(Add(ENodeKind::AlternativePart, { +node.Else }, node.Empty), node);
+		}
+
+		virtual void Visit(NConditionalExpr& node) override
+		{
+			Schedule(Add(ENodeKind::ConditionalExpr, { +node.Op }), node);
+		}
+
+		virtual void Visit(NExpr& node) override {}
+
+		virtual void Visit(NVariableIdentifier& node) override
+		{
+			Schedule(Add(ENodeKind::VariableIdentifier, {}), node);
+		}
+
+		virtual void Visit(NProcedureIdentifier& node) override
+		{
+			Schedule(Add(ENodeKind::ProcedureIdentifier, {}), node);
+		}
+
+		virtual void Visit(NIdentifier& node) override
+		{
+			Add(ENodeKind::Identifier, { node.Identifier, node.TokenIndex, m_Tokens.StartOffset(node.TokenIndex) });
+		}
+
+		virtual void Visit(NConstant& node) override
+		{
+			Add(ENodeKind::Constant, { node.Val, node.TokenIndex, m_Tokens.StartOffset(node.TokenIndex) });
+		}
+
+	private:
+		static constexpr uint32_t ListSlot = UINT32_MAX;
+
+		// A node waiting for its record, and where to put the record's index: a child slot of 'Parent', or m_Items[Parent]
+		struct Pending
+		{
+			Ref<ASTNode> Node;
+			uint32_t Parent;
+			uint32_t Slot;
+		};
+
+		uint32_t Add(ENodeKind kind, std::initializer_list<uint32_t> codes, bool flag = false)
+		{
+			uint32_t index = static_cast<uint32_t>(m_Nodes.size());
+			FlatNode& node = m_Nodes.emplace_back();
+			node.Kind = kind;
+			node.Flag = flag;
+			std::copy(codes.begin(), codes.end(), node.Codes);
+
+			if (m_Current.Parent == FlatNode::None)
+				return index;
+			if (m_Current.Slot == ListSlot)
+				m_Items[m_Current.Parent] = index;
+			else
+				m_Nodes[m_Current.Parent].Children[m_Current.Slot] = index;
+			return index;
+		}
+
+		// Pushed back to front, so the first child is added next
+		void Schedule(uint32_t parent, const ASTNode& node)
+		{
+			for (uint32_t slot = node.ChildCount(); slot-- > 0;)
+			{
+				if (Ref<ASTNode> child = node.Child(slot); IsValid(child))
+					m_Pending.push_back({ child, parent, slot });
+			}
+		}
+
+		// Items get their places up front, lists nested in them take the places after
+		void ScheduleList(uint32_t parent, const ASTNode& list)
+		{
+			uint32_t first = static_cast<uint32_t>(m_Items.size());
+			uint32_t count = list.ChildCount();
+			m_Items.resize(first + count, FlatNode::None);
+			m_Nodes[parent].Children[0] = first;
+			m_Nodes[parent].Children[1] = count;
+
+			for (uint32_t i = count; i-- > 0;)
+			{
+				if (Ref<ASTNode> item = list.Child(i); IsValid(item))
+					m_Pending.push_back({ item, first + i, ListSlot });
+			}
+		}
+
+	private:
+		std::vector<FlatNode>& m_Nodes;
+		std::vector<uint32_t>& m_Items;
+		const TokenStream& m_Tokens;
+		std::vector<Pending> m_Pending;
+		Pending m_Current = { nullptr, FlatNode::None, 0 };
+	};
+}
+
+void FlatAST::Build(Ref<ASTNode> root, const TokenStream& tokens)
+{
+	Clear();
+	if (root)
+		FlatASTBuilder(m_OwnNodes, m_OwnItems, tokens).Build(root);
+	m_Nodes = m_OwnNodes;
+	m_Items = m_OwnItems;
+}
+
+void FlatAST::View(std::span<const FlatNode> nodes, std::span<const uint32_t> items)
+{
+	Clear();
+	m_Nodes = nodes;
+	m_Items = items;
+}
+
+// Children come after their parent, so going back to front makes every child before the node that needs it
+Ref<ASTNode> FlatAST::Inflate(NodeArena& arena) const
+{
+	if (Empty())
+		return nullptr;
+
+	std::vector<Ref<ASTNode>> made(Size(), nullptr);
+	std::vector<Ref<ASTNode>> listItems;
+	auto child = [&](uint32_t index) -> Ref<ASTNode> { return index == FlatNode::None ? nullptr : made[index]; };
+	auto code = [](const FlatNode& node, uint32_t i) { return static_cast<ETokenCode>(node.Codes[i]); };
+	auto list = [&](const FlatNode& node)
+	{
+		listItems.clear();
+		for (uint32_t item : ListItems(node))
+			listItems.push_back(child(item));
+		return NodeList{ arena.Copy(listItems.data(), listItems.size()), static_cast<uint32_t>(listItems.size()) };
+	};
+
+	for (uint32_t i = Size(); i-- > 0;)
+	{
+		const FlatNode& node = m_Nodes[i];
+		Ref<ASTNode> first = child(node.Children[0]);
+		Ref<ASTNode> second = child(node.Children[1]);
+		switch (node.Kind)
+		{
+		case ENodeKind::SignalProgram:				made[i] = AST::MakeSignalProgram(arena, first); break;
+		case ENodeKind::Program:					made[i] = AST::MakeProgram(arena, code(node, 0), first, code(node, 1), second, code(node, 2)); break;
+		case ENodeKind::Block:						made[i] = AST::MakeBlock(arena, first, code(node, 0), second, code(node, 1)); break;
+		case ENodeKind::VariableDeclarations:		made[i] = AST::MakeVariableDeclarations(arena, code(node, 0), first, node.Flag); break;
+		case ENodeKind::DeclarationsList:			made[i] = AST::MakeDeclarationsList(arena, list(node)); break;
+		case ENodeKind::Declaration:				made[i] = AST::MakeDeclaration(arena, first, code(node, 0), second, code(node, 1)); break;
+		case ENodeKind::Attribute:					made[i] = AST::MakeAttribute(arena, code(node, 0)); break;
+		case ENodeKind::StmtsList:					made[i] = AST::MakeStmtsList(arena, list(node), node.Flag); break;
+		case ENodeKind::IfStmt:						made[i] = AST::MakeIfStmt(arena, first, code(node, 0), code(node, 1)); break;
+		case ENodeKind::AssignStmt:					made[i] = AST::MakeAssignStmt(arena, first, code(node, 0), second, code(node, 1)); break;
+		case ENodeKind::ConditionStmt:				made[i] = AST::MakeConditionStmt(arena, first, second); break;
+		case ENodeKind::IncompleteConditionStmt:	made[i] = AST::MakeIncompleteConditionStmt(arena, code(node, 0), first, code(node, 1), second); break;
+		case ENodeKind::AlternativePart:			made[i] = AST::MakeAlternativePart(arena, code(node, 0), first, node.Flag); break;
+		case ENodeKind::ConditionalExpr:			made[i] = AST::MakeConditionalExpr(arena, first, code(node, 0), second); break;
+		case ENodeKind::VariableIdentifier:			made[i] = AST::MakeVariableIdentifier(arena, first); break;
+		case ENodeKind::ProcedureIdentifier:		made[i] = AST::MakeProcedureIdentifier(arena, first); break;
+		case ENodeKind::Identifier:					made[i] = AST::MakeIdentifier(arena, node.Codes[0], node.Codes[1]); break;
+		case ENodeKind::Constant:					made[i] = AST::MakeConstant(arena, node.Codes[0], node.Codes[1]); break;
+		}
+	}
+	return made[0];
+}
+
+// Leaves are in source order, so their tokens are pinned in the order the stream wants
+void FlatAST::PinLeafTokens(TokenStream& tokens) const
+{
+	for (const FlatNode& node : m_Nodes)
+	{
+		if (node.Kind == ENodeKind::Identifier || node.Kind == ENodeKind::Constant)
+			tokens.Pin(node.Codes[1], node.Codes[2]);
+	}
+}
+
+void FlatAST::Clear()
+{
+	m_Nodes = {};
+	m_Items = {};
+	m_OwnNodes.clear();
+	m_OwnItems.clear();
+}
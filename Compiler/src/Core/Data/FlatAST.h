@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Data/ASTNode.h"
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+class NodeArena;
+class TokenStream;
+
+enum class ENodeKind : uint8_t
+{
+	SignalProgram,
+	Program,
+	Block,
+	VariableDeclarations,
+	DeclarationsList,
+	Declaration,
+	Attribute,
+	StmtsList,
+	IfStmt,
+	AssignStmt,
+	ConditionStmt,
+	IncompleteConditionStmt,
+	AlternativePart,
+	ConditionalExpr,
+	VariableIdentifier,
+	ProcedureIdentifier,
+	Identifier,
+	Constant
+};
+
+// One node of a FlatAST. Fields follow the grammar order of the node they stand for
+struct FlatNode
+{
+	static constexpr uint32_t None = UINT32_MAX;	// Missing child
+
+	ENodeKind Kind;
+	uint8_t Flag = 0;			// Empty, or Complete for a statements list
+	uint16_t Reserved = 0;
+	uint32_t Codes[3] = {};		// Token codes. An identifier or constant holds its table index, token index and the offset of the token
+	uint32_t Children[2] = { None, None };	// Child indices. A list holds the first and count of its items in FlatAST::Items
+};
+static_assert(sizeof(FlatNode) == 24, "FlatNode is written out as is");
+
+// The AST as one array of fixed size records in pre-order, with the items of every list in a side array.
+// A walk front to back visits the tree in source order, and there are no pointers in it,
+// so it can be written out or shared between threads without fixing anything up
+class FlatAST
+{
+public:
+	FlatAST() = default;
+	FlatAST(const FlatAST&) = delete;
+	FlatAST& operator=(const FlatAST&) = delete;
+
+	// Built without recursion, any depth of nesting is fine. 'tokens' are the ones the leaves of the tree refer to
+	void Build(Ref<ASTNode> root, const TokenStream& tokens);
+	// Uses records kept elsewhere, such as a mapped ASTImage, which must outlive the view
+	void View(std::span<const FlatNode> nodes, std::span<const uint32_t> items);
+	// Makes the nodes again, in 'arena'
+	Ref<ASTNode> Inflate(NodeArena& arena) const;
+	// Lets 'tokens' locate the tokens of identifiers and constants without holding them
+	void PinLeafTokens(TokenStream& tokens) const;
+
+	void Clear();
+	bool Empty() const { return m_Nodes.empty(); }
+	uint32_t Size() const { return static_cast<uint32_t>(m_Nodes.size()); }
+
+	const FlatNode& operator[](uint32_t index) const { return m_Nodes[index]; }
+	std::span<const uint32_t> ListItems(const FlatNode& list) const { return { m_Items.data() + list.Children[0], list.Children[1] }; }
+
+	std::span<const FlatNode> Nodes() const { return m_Nodes; }
+	std::span<const uint32_t> Items() const { return m_Items; }
+
+private:
+	std::span<const FlatNode> m_Nodes;
+	std::span<const uint32_t> m_Items;
+	std::vector<FlatNode> m_OwnNodes;		// Behind the spans unless this is a view
+	std::vector<uint32_t> m_OwnItems;
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Data/Token.h"
+
+#include <array>
+#include <string_view>
+#include <cstdint>
+
+// Fixed keyword set, recognized through a perfect hash that is built and checked at compile time
+namespace Keywords
+{
+	struct Keyword
+	{
+		std::string_view Lexeme;
+		ETokenCode Code;
+	};
+
+	inline constexpr std::array<Keyword, 11> List =
+	{ {
+		{ "PROGRAM",	ETokenCode::KW_PROGRAM },
+		{ "VAR",		ETokenCode::KW_VAR },
+		{ "BEGIN",		ETokenCode::KW_BEGIN },
+		{ "END",		ETokenCode::KW_END },
+		{ "INTEGER",	ETokenCode::KW_INTEGER },
+		{ "FLOAT",		ETokenCode::KW_FLOAT },
+		{ "IF",			ETokenCode::KW_IF },
+		{ "THEN",		ETokenCode::KW_THEN },
+		{ "ELSE",		ETokenCode::KW_ELSE },
+		{ "ENDIF",		ETokenCode::KW_ENDIF },
+		{ ":=",			ETokenCode::DelimiterAssign }
+	} };
+
+	inline constexpr size_t TableSize = 16;
+
+	constexpr size_t Hash(std::string_view lexeme)
+	{
+		return (lexeme.size() + static_cast<unsigned char>(lexeme.front()) + static_cast<unsigned char>(lexeme.back())) & (TableSize - 1);
+	}
+
+	struct HashTable
+	{
+		std::array<Keyword, TableSize> Slots{};
+		size_t MinLength = SIZE_MAX;
+		size_t MaxLength = 0;
+		bool bPerfect = true;
+	};
+
+	constexpr HashTable BuildTable()
+	{
+		HashTable table;
+		for (const Keyword& keyword : List)
+		{
+			Keyword& slot = table.Slots[Hash(keyword.Lexeme)];
+			if (!slot.Lexeme.empty())
+				table.bPerfect = false;
+			slot = keyword;
+			table.MinLength = keyword.Lexeme.size() < table.MinLength ? keyword.Lexeme.size() : table.MinLength;
+			table.MaxLength = keyword.Lexeme.size() > table.MaxLength ? keyword.Lexeme.size() : table.MaxLength;
+		}
+		return table;
+	}
+
+	inline constexpr HashTable Table = BuildTable();
+	static_assert(Table.bPerfect, "Keyword hash has collisions, adjust Keywords::Hash or Keywords::TableSize");
+
+	// Returns ETokenCode::None for anything that is not a keyword
+	constexpr ETokenCode Find(std::string_view lexeme)
+	{
+		if (lexeme.size() < Table.MinLength || lexeme.size() > Table.MaxLength)
+			return ETokenCode::None;
+
+		const Keyword& slot = Table.Slots[Hash(lexeme)];
+		return slot.Lexeme == lexeme ? slot.Code : ETokenCode::None;
+	}
+
+	constexpr std::string_view ToString(ETokenCode code)
+	{
+		for (const Keyword& keyword : List)
+		{
+			if (keyword.Code == code)
+				return keyword.Lexeme;
+		}
+		return {};
+	}
+
+	static_assert(Find("ENDIF") == ETokenCode::KW_ENDIF && Find(":=") == ETokenCode::DelimiterAssign && Find("ENDIFF") == ETokenCode::None);
+}
@@ -0,0 +1,63 @@
+#include "LineIndex.h"
+
+#include <algorithm>
+#include <cstring>
+
+// 'from' is at offset 'fromOffset'
+static void CollectOffsets(std::vector<uint32_t>& offsets, size_t fromOffset, const char* from, const char* to, char c)
+{
+	const char* p = from;
+	while (const void* found = std::memchr(p, c, to - p))
+	{
+		p = static_cast<const char*>(found);
+		offsets.push_back(static_cast<uint32_t>(fromOffset + (p - from)));
+		p++;
+	}
+}
+
+void LineIndex::Build(const char* begin, const char* end)
+{
+	Clear();
+	Extend(begin, end);
+}
+
+void LineIndex::Extend(const char* from, const char* upTo)
+{
+	if (upTo <= from)
+		return;
+
+	CollectOffsets(m_Newlines, m_Scanned, from, upTo, '\n');
+	CollectOffsets(m_Tabs, m_Scanned, from, upTo, '\t');
+	m_Scanned += upTo - from;
+}
+
+void LineIndex::Clear()
+{
+	m_Newlines.clear();
+	m_Tabs.clear();
+	m_Scanned = 0;
+}
+
+void LineIndex::Truncate(size_t offset)
+{
+	if (offset >= m_Scanned)
+		return;
+
+	m_Newlines.erase(std::lower_bound(m_Newlines.begin(), m_Newlines.end(), offset), m_Newlines.end());
+	m_Tabs.erase(std::lower_bound(m_Tabs.begin(), m_Tabs.end(), offset), m_Tabs.end());
+	m_Scanned = offset;
+}
+
+SourceLocation LineIndex::Locate(uint32_t offset) const
+{
+	auto next = std::upper_bound(m_Newlines.begin(), m_Newlines.end(), offset);
+	size_t line = (next - m_Newlines.begin()) + 1;
+	if (next != m_Newlines.begin() && next[-1] == offset)
+		return { line, 0 };
+
+	uint32_t lineStart = next == m_Newlines.begin() ? 0 : next[-1] + 1;
+	auto firstTab = std::lower_bound(m_Tabs.begin(), m_Tabs.end(), lineStart);
+	auto lastTab = std::upper_bound(firstTab, m_Tabs.end(), offset);
+
+	return { line, (offset - lineStart + 1) + 3 * static_cast<size_t>(lastTab - firstTab) };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+struct SourceLocation
+{
+	size_t Line;
+	size_t Position;
+};
+
+// Turns byte offsets into line/position pairs.
+// Positions count a tab as 4 columns and every other byte as 1, a line break sits at position 0 of the line it starts.
+// Offsets are kept in 32 bits like those of TokenStream.
+class LineIndex
+{
+public:
+	void Build(const char* begin, const char* end);
+	// Indexes the text from offset Scanned() on, 'from' points at it. Offsets past Scanned() can't be located yet
+	void Extend(const char* from, const char* upTo);
+	void Clear();
+	// Forgets the text from 'offset' on, for a source edited there
+	void Truncate(size_t offset);
+	size_t Scanned() const { return m_Scanned; }
+
+	SourceLocation Locate(uint32_t offset) const;
+	size_t LineCount() const { return m_Newlines.size() + 1; }
+
+private:
+	std::vector<uint32_t> m_Newlines;
+	std::vector<uint32_t> m_Tabs;
+	size_t m_Scanned = 0;
+};
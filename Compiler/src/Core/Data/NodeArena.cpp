@@ -0,0 +1,31 @@
+#include "NodeArena.h"
+
+#include <algorithm>
+
+static constexpr size_t s_BlockSize = 64 << 10;
+
+void NodeArena::Clear()
+{
+	m_Blocks.clear();
+	m_Cursor = nullptr;
+	m_End = nullptr;
+	m_Used = 0;
+}
+
+void NodeArena::Adopt(NodeArena& other)
+{
+	for (std::unique_ptr<std::byte[]>& block : other.m_Blocks)
+		m_Blocks.push_back(std::move(block));
+	m_Used += other.m_Used;
+	other.Clear();
+}
+
+void* NodeArena::AllocateInNewBlock(size_t size, size_t alignment)
+{
+	// new[] aligns blocks for any fundamental type, so the padding is never more than 'alignment'
+	size_t blockSize = std::max(s_BlockSize, size + alignment);
+	m_Blocks.emplace_back(new std::byte[blockSize]);
+	m_Cursor = m_Blocks.back().get();
+	m_End = m_Cursor + blockSize;
+	return Allocate(size, alignment);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Bump allocator for the AST of one compilation. Nodes are carved out of large blocks and
+// released all at once with the arena, none of them is ever destroyed on its own,
+// so only types that need no destructor can be made here.
+class NodeArena
+{
+public:
+	NodeArena() = default;
+	NodeArena(const NodeArena&) = delete;
+	NodeArena& operator=(const NodeArena&) = delete;
+
+	template<typename T, typename... Args>
+	T* Make(Args&&... args)
+	{
+		static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+		return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+	}
+
+	template<typename T>
+	T* Copy(const T* items, size_t count)
+	{
+		static_assert(std::is_trivially_copyable_v<T>, "Arena arrays are copied bytewise");
+		if (count == 0)
+			return nullptr;
+		return static_cast<T*>(std::memcpy(Allocate(sizeof(T) * count, alignof(T)), items, sizeof(T) * count));
+	}
+
+	// Frees every node made so far
+	void Clear();
+	// Takes over the nodes made in 'other', they stay where they are. 'other' is left empty
+	void Adopt(NodeArena& other);
+	size_t BytesUsed() const { return m_Used; }
+
+private:
+	void* Allocate(size_t size, size_t alignment)
+	{
+		size_t padding = (alignment - reinterpret_cast<uintptr_t>(m_Cursor) % alignment) % alignment;
+		if (padding + size > static_cast<size_t>(m_End - m_Cursor))
+			return AllocateInNewBlock(size, alignment);
+
+		std::byte* memory = m_Cursor + padding;
+		m_Cursor = memory + size;
+		m_Used += size;
+		return memory;
+	}
+
+	void* AllocateInNewBlock(size_t size, size_t alignment);
+
+private:
+	std::vector<std::unique_ptr<std::byte[]>> m_Blocks;
+	std::byte* m_Cursor = nullptr;
+	std::byte* m_End = nullptr;
+	size_t m_Used = 0;
+};
@@ -1,11 +1,17 @@
 #include "Nodes.h"
 #include "Data/Visitor.h"
+#include "Data/NodeArena.h"
 
 using namespace AST;
 
-std::vector<Ref<ASTNode>> NSignalProgram::GetData()
+uint32_t NSignalProgram::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 1;
+}
+
+Ref<ASTNode> NSignalProgram::Child(uint32_t index) const
+{
+	return Program;
 }
 
 std::string NSignalProgram::ToString()
@@ -18,9 +24,14 @@ void NSignalProgram::Accept(AST::Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NProgram::GetData()
+uint32_t NProgram::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 2;
+}
+
+Ref<ASTNode> NProgram::Child(uint32_t index) const
+{
+	return index == 0 ? ProcIdentifier : Block;
 }
 
 std::string NProgram::ToString()
@@ -33,9 +44,14 @@ void NProgram::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NBlock::GetData()
+uint32_t NBlock::ChildCount() const
+{
+	return 2;
+}
+
+Ref<ASTNode> NBlock::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return index == 0 ? VarDecl : StmtsList;
 }
 
 std::string NBlock::ToString()
@@ -48,9 +64,14 @@ void NBlock::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NVariableDeclarations::GetData()
+uint32_t NVariableDeclarations::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 1;
+}
+
+Ref<ASTNode> NVariableDeclarations::Child(uint32_t index) const
+{
+	return DeclList;
 }
 
 std::string NVariableDeclarations::ToString()
@@ -63,9 +84,14 @@ void NVariableDeclarations::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NDeclarationsList::GetData()
+uint32_t NDeclarationsList::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return Decls.Size();
+}
+
+Ref<ASTNode> NDeclarationsList::Child(uint32_t index) const
+{
+	return Decls[index];
 }
 
 std::string NDeclarationsList::ToString()
@@ -78,9 +104,14 @@ void NDeclarationsList::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NDeclaration::GetData()
+uint32_t NDeclaration::ChildCount() const
+{
+	return 2;
+}
+
+Ref<ASTNode> NDeclaration::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return index == 0 ? VarIdentifier : Attribute;
 }
 
 std::string NDeclaration::ToString()
@@ -93,9 +124,14 @@ void NDeclaration::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NAttribute::GetData()
+uint32_t NAttribute::ChildCount() const
+{
+	return 0;
+}
+
+Ref<ASTNode> NAttribute::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return nullptr;
 }
 
 std::string NAttribute::ToString()
@@ -108,9 +144,14 @@ void NAttribute::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NStmtsList::GetData()
+uint32_t NStmtsList::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return Stmts.Size();
+}
+
+Ref<ASTNode> NStmtsList::Child(uint32_t index) const
+{
+	return Stmts[index];
 }
 
 std::string NStmtsList::ToString()
@@ -123,9 +164,14 @@ void NStmtsList::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NIfStmt::GetData()
+uint32_t NIfStmt::ChildCount() const
+{
+	return 1;
+}
+
+Ref<ASTNode> NIfStmt::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return CondStmt;
 }
 
 std::string NIfStmt::ToString()
@@ -138,9 +184,14 @@ void NIfStmt::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NAssignStmt::GetData()
+uint32_t NAssignStmt::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 2;
+}
+
+Ref<ASTNode> NAssignStmt::Child(uint32_t index) const
+{
+	return index == 0 ? VarIdentifier : Expr;
 }
 
 std::string NAssignStmt::ToString()
@@ -153,9 +204,14 @@ void NAssignStmt::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NConditionStmt::GetData()
+uint32_t NConditionStmt::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 2;
+}
+
+Ref<ASTNode> NConditionStmt::Child(uint32_t index) const
+{
+	return index == 0 ? IncompleteCondStmt : AltPart;
 }
 
 std::string NConditionStmt::ToString()
@@ -168,9 +224,14 @@ void NConditionStmt::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NIncompleteConditionStmt::GetData()
+uint32_t NIncompleteConditionStmt::ChildCount() const
+{
+	return 2;
+}
+
+Ref<ASTNode> NIncompleteConditionStmt::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return index == 0 ? CondExpr : StmtsList;
 }
 
 std::string NIncompleteConditionStmt::ToString()
@@ -183,9 +244,14 @@ void NIncompleteConditionStmt::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NAlternativePart::GetData()
+uint32_t NAlternativePart::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 1;
+}
+
+Ref<ASTNode> NAlternativePart::Child(uint32_t index) const
+{
+	return StmtsList;
 }
 
 std::string NAlternativePart::ToString()
@@ -198,9 +264,14 @@ void NAlternativePart::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NConditionalExpr::GetData()
+uint32_t NConditionalExpr::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 2;
+}
+
+Ref<ASTNode> NConditionalExpr::Child(uint32_t index) const
+{
+	return index == 0 ? Expr1 : Expr2;
 }
 
 std::string NConditionalExpr::ToString()
@@ -213,9 +284,14 @@ void NConditionalExpr::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NVariableIdentifier::GetData()
+uint32_t NVariableIdentifier::ChildCount() const
+{
+	return 1;
+}
+
+Ref<ASTNode> NVariableIdentifier::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return Identifier;
 }
 
 std::string NVariableIdentifier::ToString()
@@ -228,9 +304,14 @@ void NVariableIdentifier::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NProcedureIdentifier::GetData()
+uint32_t NProcedureIdentifier::ChildCount() const
+{
+	return 1;
+}
+
+Ref<ASTNode> NProcedureIdentifier::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return Identifier;
 }
 
 std::string NProcedureIdentifier::ToString()
@@ -243,9 +324,14 @@ void NProcedureIdentifier::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NIdentifier::GetData()
+uint32_t NIdentifier::ChildCount() const
 {
-	return std::vector<Ref<ASTNode>>();
+	return 0;
+}
+
+Ref<ASTNode> NIdentifier::Child(uint32_t index) const
+{
+	return nullptr;
 }
 
 std::string NIdentifier::ToString()
@@ -258,9 +344,14 @@ void NIdentifier::Accept(Visitor& visitor)
 	visitor.Visit(*this);
 }
 
-std::vector<Ref<ASTNode>> NConstant::GetData()
+uint32_t NConstant::ChildCount() const
+{
+	return 0;
+}
+
+Ref<ASTNode> NConstant::Child(uint32_t index) const
 {
-	return std::vector<Ref<ASTNode>>();
+	return nullptr;
 }
 
 std::string NConstant::ToString()
@@ -275,77 +366,77 @@ void NConstant::Accept(Visitor& visitor)
 
 namespace AST
 {
-	Ref<ASTNode> MakeSignalProgram(Ref<ASTNode> program)
+	Ref<ASTNode> MakeSignalProgram(NodeArena& arena, Ref<ASTNode> program)
 	{
-		return std::make_shared<NSignalProgram>(program);
+		return arena.Make<NSignalProgram>(program);
 	}
-	Ref<ASTNode> MakeProgram(ETokenCode program, Ref<ASTNode> procId, ETokenCode sc, Ref<ASTNode> block, ETokenCode dot)
+	Ref<ASTNode> MakeProgram(NodeArena& arena, ETokenCode program, Ref<ASTNode> procId, ETokenCode sc, Ref<ASTNode> block, ETokenCode dot)
 	{
-		return std::make_shared<NProgram>(program, procId, sc, block, dot);
+		return arena.Make<NProgram>(program, procId, sc, block, dot);
 	}
-	Ref<ASTNode> MakeBlock(Ref<ASTNode> varDecl, ETokenCode begin, Ref<ASTNode> stmtList, ETokenCode end)
+	Ref<ASTNode> MakeBlock(NodeArena& arena, Ref<ASTNode> varDecl, ETokenCode begin, Ref<ASTNode> stmtList, ETokenCode end)
 	{
-		return std::make_shared<NBlock>(varDecl, begin, stmtList, end);
+		return arena.Make<NBlock>(varDecl, begin, stmtList, end);
 	}
-	Ref<ASTNode> MakeVariableDeclarations(ETokenCode var, Ref<ASTNode> declList, bool empty)
+	Ref<ASTNode> MakeVariableDeclarations(NodeArena& arena, ETokenCode var, Ref<ASTNode> declList, bool empty)
 	{
-		return std::make_shared<NVariableDeclarations>(var, declList, empty);
+		return arena.Make<NVariableDeclarations>(var, declList, empty);
 	}
-	Ref<ASTNode> MakeDeclarationsList(Ref<ASTNode> decl, Ref<ASTNode> declList, bool empty)
+	Ref<ASTNode> MakeDeclarationsList(NodeArena& arena, NodeList decls)
 	{
-		return std::make_shared<NDeclarationsList>(decl, declList, empty);
+		return arena.Make<NDeclarationsList>(decls);
 	}
-	Ref<ASTNode> MakeDeclaration(Ref<ASTNode> varId, ETokenCode colon, Ref<ASTNode> atr, ETokenCode sc)
+	Ref<ASTNode> MakeDeclaration(NodeArena& arena, Ref<ASTNode> varId, ETokenCode colon, Ref<ASTNode> atr, ETokenCode sc)
 	{
-		return std::make_shared<NDeclaration>(varId, colon, atr, sc);
+		return arena.Make<NDeclaration>(varId, colon, atr, sc);
 	}
-	Ref<ASTNode> MakeAttribute(ETokenCode type)
+	Ref<ASTNode> MakeAttribute(NodeArena& arena, ETokenCode type)
 	{
-		return std::make_shared<NAttribute>(type);
+		return arena.Make<NAttribute>(type);
 	}
-	Ref<ASTNode> MakeStmtsList(Ref<ASTNode> stmt, Ref<ASTNode> stmtsList, bool empty)
+	Ref<ASTNode> MakeStmtsList(NodeArena& arena, NodeList stmts, bool complete)
 	{
-		return std::make_shared<NStmtsList>(stmt, stmtsList, empty);
+		return arena.Make<NStmtsList>(stmts, complete);
 	}
-	Ref<ASTNode> MakeIfStmt(Ref<ASTNode> condStmt, ETokenCode eif, ETokenCode sc)
+	Ref<ASTNode> MakeIfStmt(NodeArena& arena, Ref<ASTNode> condStmt, ETokenCode eif, ETokenCode sc)
 	{
-		return std::make_shared<NIfStmt>(condStmt, eif, sc);
+		return arena.Make<NIfStmt>(condStmt, eif, sc);
 	}
-	Ref<ASTNode> MakeAssignStmt(Ref<ASTNode> varId, ETokenCode op, Ref<ASTNode> expr, ETokenCode sc)
+	Ref<ASTNode> MakeAssignStmt(NodeArena& arena, Ref<ASTNode> varId, ETokenCode op, Ref<ASTNode> expr, ETokenCode sc)
 	{
-		return std::make_shared<NAssignStmt>(varId, op, expr, sc);
+		return arena.Make<NAssignStmt>(varId, op, expr, sc);
 	}
-	Ref<ASTNode> MakeConditionStmt(Ref<ASTNode> incCondStmt, Ref<ASTNode> alt)
+	Ref<ASTNode> MakeConditionStmt(NodeArena& arena, Ref<ASTNode> incCondStmt, Ref<ASTNode> alt)
 	{
-		return std::make_shared<NConditionStmt>(incCondStmt, alt);
+		return arena.Make<NConditionStmt>(incCondStmt, alt);
 	}
-	Ref<ASTNode> MakeIncompleteConditionStmt(ETokenCode _if, Ref<ASTNode> condExpr, ETokenCode then, Ref<ASTNode> stmtsList)
+	Ref<ASTNode> MakeIncompleteConditionStmt(NodeArena& arena, ETokenCode _if, Ref<ASTNode> condExpr, ETokenCode then, Ref<ASTNode> stmtsList)
 	{
-		return std::make_shared<NIncompleteConditionStmt>(_if, condExpr, then, stmtsList);
+		return arena.Make<NIncompleteConditionStmt>(_if, condExpr, then, stmtsList);
 	}
-	Ref<ASTNode> MakeAlternativePart(ETokenCode _else, Ref<ASTNode> stmtsList, bool empty)
+	Ref<ASTNode> MakeAlternativePart(NodeArena& arena, ETokenCode _else, Ref<ASTNode> stmtsList, bool empty)
 	{
-		return std::make_shared<NAlternativePart>(_else, stmtsList, empty);
+		return arena.Make<NAlternativePart>(_else, stmtsList, empty);
 	}
-	Ref<ASTNode> MakeConditionalExpr(Ref<ASTNode> expr1, ETokenCode op, Ref<ASTNode> expr2)
+	Ref<ASTNode> MakeConditionalExpr(NodeArena& arena, Ref<ASTNode> expr1, ETokenCode op, Ref<ASTNode> expr2)
 	{
-		return std::make_shared<NConditionalExpr>(expr1, op, expr2);
+		return arena.Make<NConditionalExpr>(expr1, op, expr2);
 	}
-	Ref<ASTNode> MakeVariableIdentifier(Ref<ASTNode> id)
+	Ref<ASTNode> MakeVariableIdentifier(NodeArena& arena, Ref<ASTNode> id)
 	{
-		return std::make_shared<NVariableIdentifier>(id);
+		return arena.Make<NVariableIdentifier>(id);
 	}
-	Ref<ASTNode> MakeProcedureIdentifier(Ref<ASTNode> id)
+	Ref<ASTNode> MakeProcedureIdentifier(NodeArena& arena, Ref<ASTNode> id)
 	{
-		return std::make_shared<NProcedureIdentifier>(id);
+		return arena.Make<NProcedureIdentifier>(id);
 	}
-	Ref<ASTNode> MakeIdentifier(uint32_t id, const Token& tok)
+	Ref<ASTNode> MakeIdentifier(NodeArena& arena, uint32_t id, uint32_t token)
 	{
-		return std::make_shared<NIdentifier>(id, tok);
+		return arena.Make<NIdentifier>(id, token);
 	}
-	Ref<ASTNode> MakeConstant(uint32_t value, const Token& tok)
+	Ref<ASTNode> MakeConstant(NodeArena& arena, uint32_t value, uint32_t token)
 	{
-		return std::make_shared<NConstant>(value, tok);
+		return arena.Make<NConstant>(value, token);
 	}
 
 }
\ No newline at end of file
@@ -12,7 +12,8 @@ struct NSignalProgram : public ASTNode
 	NSignalProgram(Ref<ASTNode> program) : Program(program) {}
 
 	Ref<ASTNode> Program;
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 
@@ -28,7 +29,8 @@ struct NProgram : public ASTNode
 	Ref<ASTNode> Block;
 	ETokenCode Dot;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -42,7 +44,8 @@ struct NBlock : public ASTNode
 	Ref<ASTNode> StmtsList;
 	ETokenCode End;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -57,21 +60,20 @@ struct NVariableDeclarations : public ASTNode
 
 	bool Empty = false;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
+// The grammar's right-recursive <declarations-list>, flattened. Declarations that failed to parse are nullptr
 struct NDeclarationsList : public ASTNode
 {
-	NDeclarationsList(Ref<ASTNode> decl, Ref<ASTNode> declList, bool empty)
-		: Decl(decl), DeclList(declList), Empty(empty) {}
+	NDeclarationsList(NodeList decls) : Decls(decls) {}
 
-	Ref<ASTNode> Decl;
-	Ref<ASTNode> DeclList;
-
-	bool Empty = false;
+	NodeList Decls;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -85,7 +87,8 @@ struct NDeclaration : public ASTNode
 	Ref<ASTNode> Attribute;
 	ETokenCode Semicolon;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -95,7 +98,8 @@ struct NAttribute : public ASTNode
 
 	ETokenCode Type;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -103,17 +107,19 @@ struct NStmt : public ASTNode
 {
 
 };
+// The grammar's right-recursive <statements-list>, flattened.
+// An incomplete list stopped at a statement that failed to parse, where the recursive one had a nullptr tail
 struct NStmtsList : public NStmt
 {
-	NStmtsList(Ref<ASTNode> stmt, Ref<ASTNode> stmtsList, bool empty)
-		: Stmt(stmt), StmtsList(stmtsList), Empty(empty) {}
+	NStmtsList(NodeList stmts, bool complete)
+		: Stmts(stmts), Complete(complete) {}
 
-	Ref<ASTNode> Stmt;
-	Ref<ASTNode> StmtsList;
+	NodeList Stmts;
 
-	bool Empty = false;
+	bool Complete = true;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -126,7 +132,8 @@ struct NIfStmt : public NStmt
 	ETokenCode Endif;
 	ETokenCode Semicolon;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -140,7 +147,8 @@ struct NAssignStmt : public NStmt
 	Ref<ASTNode> Expr;
 	ETokenCode Semicolon;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -153,7 +161,8 @@ struct NConditionStmt : public NStmt
 	Ref<ASTNode> IncompleteCondStmt;
 	Ref<ASTNode> AltPart;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -167,7 +176,8 @@ struct NIncompleteConditionStmt : public ASTNode
 	ETokenCode Then;
 	Ref<ASTNode> StmtsList;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -182,7 +192,8 @@ struct NAlternativePart : public ASTNode
 
 	bool Empty = false;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -195,7 +206,8 @@ struct NConditionalExpr : public ASTNode
 	ETokenCode Op;
 	Ref<ASTNode> Expr2;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -209,7 +221,8 @@ struct NVariableIdentifier : public NExpr
 
 	Ref<ASTNode> Identifier;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
@@ -220,32 +233,33 @@ struct NProcedureIdentifier : public ASTNode
 
 	Ref<ASTNode> Identifier;
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
 };
 
 struct NIdentifier : public ASTNode
 {
-	NIdentifier(uint32_t id, const Token& tok) : token(tok), Identifier(id) {}
+	NIdentifier(uint32_t id, uint32_t token) : Identifier(id), TokenIndex(token) {}
 
 	uint32_t Identifier;
+	uint32_t TokenIndex;	// Into CompilationContext::Tokens
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
-
-	Token token;
 };
 struct NConstant : public NExpr
 {
-	NConstant(uint32_t value, const Token& tok) : token(tok), Val(value) {}
+	NConstant(uint32_t value, uint32_t token) : Val(value), TokenIndex(token) {}
 
 	uint32_t Val;
+	uint32_t TokenIndex;	// Into CompilationContext::Tokens
 
-	virtual std::vector<Ref<ASTNode>> GetData() override;
+	virtual uint32_t ChildCount() const override;
+	virtual Ref<ASTNode> Child(uint32_t index) const override;
 	virtual std::string ToString() override;
 	virtual void Accept(AST::Visitor& visitor) override;
-
-	Token token;
 };
@@ -0,0 +1,257 @@
+#include "SourceBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+	#define WIN32_LEAN_AND_MEAN
+	#define NOMINMAX
+	#include <windows.h>
+	#include <fcntl.h>
+	#include <io.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+static constexpr size_t s_ReadChunkSize = 1 << 20;
+static constexpr size_t s_MinGapSize = 1 << 16;
+static constexpr const char* s_StdinPath = "-";
+
+SourceBuffer::~SourceBuffer()
+{
+	Close();
+}
+
+bool SourceBuffer::Open(const std::string& filePath)
+{
+	if (!OpenChunked(filePath))
+		return false;
+	while (HasMore())
+		ReadMore(m_First);
+	return !bTooLarge;
+}
+
+bool SourceBuffer::OpenChunked(const std::string& filePath)
+{
+	Close();
+	m_FilePath = filePath;
+
+	if (filePath != s_StdinPath && Map())
+		return true;
+	if (bTooLarge || !OpenFile())
+		return false;
+	ReadMore(0);
+	return true;
+}
+
+void SourceBuffer::ReadMore(uint32_t keepFrom)
+{
+	size_t dropped = keepFrom - m_First;
+	size_t kept = m_Size - dropped;
+	if (dropped > 0)
+		std::memmove(m_Storage.data(), m_Storage.data() + dropped, kept);
+	m_First = keepFrom;
+
+	if (m_Storage.size() < kept + s_ReadChunkSize)
+		m_Storage.resize(std::max(kept + s_ReadChunkSize, m_Storage.size() * 2));
+	size_t space = m_Storage.size() - kept;
+	size_t read = std::fread(m_Storage.data() + kept, 1, space, m_File);
+
+	m_Data = m_Storage.data();
+	m_Size = kept + read;
+	if (m_First + m_Size > MaxSize)
+	{
+		m_Size = MaxSize - m_First;
+		bTooLarge = true;
+	}
+	if (read < space || bTooLarge)
+	{
+		if (m_File != stdin)
+			std::fclose(m_File);
+		m_File = nullptr;
+	}
+}
+
+void SourceBuffer::Close()
+{
+	if (bMapped && m_Size > 0)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_Data);
+#else
+		munmap(const_cast<char*>(m_Data), m_Size);
+#endif
+	}
+	if (m_File && m_File != stdin)
+		std::fclose(m_File);
+	m_File = nullptr;
+	m_Data = nullptr;
+	m_Size = 0;
+	m_First = 0;
+	bMapped = false;
+	bTooLarge = false;
+	m_Storage.clear();
+	m_Storage.shrink_to_fit();
+	m_GapAt = NoGap;
+	m_GapSize = 0;
+}
+
+std::string SourceBuffer::GetOpenError() const
+{
+	if (bTooLarge)
+		return "Source file is too large, the limit is 4 GiB: " + m_FilePath;
+	return "No such file or directory: " + m_FilePath;
+}
+
+void SourceBuffer::Edit(size_t offset, size_t removed, std::string_view inserted)
+{
+	if (bMapped || m_GapSize < inserted.size())
+		Own(std::max(s_MinGapSize, m_Size / 8) + inserted.size());
+
+	// The removed text follows the gap once it is at 'offset', taking it in leaves room for the inserted text
+	MoveGap(offset);
+	m_Size -= removed;
+	m_GapSize += removed;
+	std::copy(inserted.begin(), inserted.end(), m_Storage.data() + offset);
+	m_Size += inserted.size();
+	m_GapSize -= inserted.size();
+	m_GapAt = offset + inserted.size() == m_Size ? NoGap : offset + inserted.size();
+}
+
+// Moves the text between the gap and 'offset' over it, the further the gap is the more that takes
+void SourceBuffer::MoveGap(size_t offset)
+{
+	if (m_GapSize == 0)
+		return;
+
+	size_t at = std::min(m_GapAt, m_Size);
+	char* data = m_Storage.data();
+	if (offset < at)
+		std::memmove(data + offset + m_GapSize, data + offset, at - offset);
+	else if (offset > at)
+		std::memmove(data + at, data + at + m_GapSize, offset - at);
+	m_GapAt = offset == m_Size ? NoGap : offset;
+}
+
+// Copies the text into an owned buffer, with 'spare' bytes of room after it
+void SourceBuffer::Own(size_t spare)
+{
+	size_t size = m_Size;
+	size_t beforeGap = std::min(m_GapAt, m_Size);
+	std::vector<char> storage(size + spare);
+	std::copy(m_Data, m_Data + beforeGap, storage.data());
+	std::copy(m_Data + beforeGap + m_GapSize, m_Data + size + m_GapSize, storage.data() + beforeGap);
+
+	std::string filePath = std::move(m_FilePath);
+	Close();
+	m_FilePath = std::move(filePath);
+	m_Storage = std::move(storage);
+	m_Data = m_Storage.data();
+	m_Size = size;
+	m_GapSize = spare;
+}
+
+#ifdef _WIN32
+
+bool SourceBuffer::Map()
+{
+	HANDLE file = CreateFileA(m_FilePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &size))
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	if (static_cast<uint64_t>(size.QuadPart) > MaxSize)
+	{
+		CloseHandle(file);
+		bTooLarge = true;
+		return false;
+	}
+
+	if (size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		bMapped = true;
+		return true;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(file);
+	if (mapping == NULL)
+		return false;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (view == NULL)
+		return false;
+
+	m_Data = static_cast<const char*>(view);
+	m_Size = static_cast<size_t>(size.QuadPart);
+	bMapped = true;
+	return true;
+}
+
+#else
+
+bool SourceBuffer::Map()
+{
+	int fd = open(m_FilePath.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+	{
+		close(fd);
+		return false;
+	}
+
+	if (static_cast<uint64_t>(info.st_size) > MaxSize)
+	{
+		close(fd);
+		bTooLarge = true;
+		return false;
+	}
+
+	if (info.st_size == 0)
+	{
+		close(fd);
+		bMapped = true;
+		return true;
+	}
+
+	void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+		return false;
+	madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+	m_Data = static_cast<const char*>(view);
+	m_Size = static_cast<size_t>(info.st_size);
+	bMapped = true;
+	return true;
+}
+
+#endif
+
+bool SourceBuffer::OpenFile()
+{
+	if (m_FilePath == s_StdinPath)
+	{
+#ifdef _WIN32
+		_setmode(_fileno(stdin), _O_BINARY);
+#endif
+		m_File = stdin;
+		return true;
+	}
+	m_File = std::fopen(m_FilePath.c_str(), "rb");
+	return m_File != nullptr;
+}
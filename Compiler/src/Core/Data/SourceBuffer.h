@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+// Read-only view of a source file, "-" stands for stdin. Regular files are memory-mapped,
+// anything that can't be mapped (pipes, character devices) is read into an owned buffer.
+// Offsets are absolute: a chunked source only holds [First(), First() + Size()), but offsets into it stay the same.
+// Edit() turns it into a gap buffer: the text is copied once into an owned buffer, which keeps its spare room at the
+// last edit so the next one nearby only moves the text in between. Text after the gap is only reached through
+// At() and View(), Begin() is contiguous up to GapAt().
+// Offsets are 32-bit, a source larger than MaxSize isn't opened and IsTooLarge() tells so
+class SourceBuffer
+{
+public:
+	SourceBuffer() = default;
+	~SourceBuffer();
+
+	SourceBuffer(const SourceBuffer&) = delete;
+	SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+	bool Open(const std::string& filePath);
+	// Like Open(), but a source that can't be mapped is read one chunk at a time with ReadMore()
+	bool OpenChunked(const std::string& filePath);
+	void Close();
+	// Why the last Open() or OpenChunked() failed, or ReadMore() stopped short
+	std::string GetOpenError() const;
+
+	// Replaces 'removed' bytes at 'offset' with 'inserted', the gap is left right after them. Not for chunked sources
+	void Edit(size_t offset, size_t removed, std::string_view inserted);
+	// Makes the text before 'offset' contiguous from Begin()
+	void MoveGap(size_t offset);
+	// Where the text jumps over the gap, NoGap while all of it is contiguous
+	size_t GapAt() const { return m_GapAt; }
+	static constexpr size_t NoGap = SIZE_MAX;
+
+	// Drops the text before 'keepFrom' and reads the next chunk in after the rest.
+	// The buffer is reused, so pointers into the held text are invalidated
+	void ReadMore(uint32_t keepFrom);
+	bool HasMore() const { return m_File != nullptr; }
+	bool IsTooLarge() const { return bTooLarge; }
+	// UINT32_MAX is kept free, it marks "no offset"
+	static constexpr size_t MaxSize = UINT32_MAX - 1;
+
+	const char* Begin() const { return m_Data; }
+	const char* End() const { return m_Data + m_Size; }
+	size_t Size() const { return m_Size; }
+	uint32_t First() const { return m_First; }
+	bool IsMapped() const { return bMapped; }
+
+	const char* At(size_t offset) const { return m_Data + (offset - m_First) + (offset >= m_GapAt ? m_GapSize : 0); }
+	std::string_view View(size_t offset, size_t length) const { return std::string_view(At(offset), length); }
+	const std::string& GetPath() const { return m_FilePath; }
+
+private:
+	bool Map();
+	bool OpenFile();
+	void Own(size_t spare);
+
+private:
+	std::string m_FilePath;
+
+	const char* m_Data = nullptr;
+	size_t m_Size = 0;
+	uint32_t m_First = 0;
+	bool bMapped = false;
+	bool bTooLarge = false;
+
+	std::vector<char> m_Storage;
+	std::FILE* m_File = nullptr;	// Open while a chunked source has more to read
+
+	size_t m_GapAt = NoGap;
+	size_t m_GapSize = 0;			// Spare room in m_Storage, after the text while there is no gap
+};
@@ -0,0 +1,125 @@
+#include "StatementWalker.h"
+#include "Data/Nodes.h"
+
+void AST::StatementWalker::Visit(NStmtsList& node)
+{
+	Walk(ENodeKind::StmtsList, node);
+}
+
+void AST::StatementWalker::Visit(NIfStmt& node)
+{
+	Walk(ENodeKind::IfStmt, node);
+}
+
+void AST::StatementWalker::Visit(NConditionStmt& node)
+{
+	Walk(ENodeKind::ConditionStmt, node);
+}
+
+void AST::StatementWalker::Visit(NIncompleteConditionStmt& node)
+{
+	Walk(ENodeKind::IncompleteConditionStmt, node);
+}
+
+void AST::StatementWalker::Visit(NAlternativePart& node)
+{
+	Walk(ENodeKind::AlternativePart, node);
+}
+
+// Hooks may accept other nodes and start walks of their own, so frames are only held by value across them
+void AST::StatementWalker::Walk(ENodeKind kind, ASTNode& node)
+{
+	size_t base = m_Frames.size();
+	Enter(kind, &node);
+	while (m_Frames.size() > base)
+	{
+		Frame frame = m_Frames.back();
+		uint32_t child = m_Frames.back().Next++;
+		switch (frame.Kind)
+		{
+		case ENodeKind::StmtsList:
+		{
+			NStmtsList& list = static_cast<NStmtsList&>(*frame.Node);
+			if (child == list.Stmts.Size())
+				break;
+
+			EnterStmtsListItem(list, child);
+			Ref<ASTNode> stmt = list.Stmts[child];
+			if (Ref<NIfStmt> ifStmt = dynamic_cast<NIfStmt*>(stmt); ifStmt)
+				Enter(ENodeKind::IfStmt, ifStmt);
+			else if (IsValid(stmt))
+				stmt->Accept(*this);
+			else
+				MissingNode();
+			continue;
+		}
+		case ENodeKind::IfStmt:
+			if (child == 0)
+			{
+				Enter(ENodeKind::ConditionStmt, static_cast<NIfStmt*>(frame.Node)->CondStmt);
+				continue;
+			}
+			break;
+		case ENodeKind::ConditionStmt:
+			if (child == 0)
+			{
+				Enter(ENodeKind::IncompleteConditionStmt, static_cast<NConditionStmt*>(frame.Node)->IncompleteCondStmt);
+				continue;
+			}
+			if (child == 1)
+			{
+				Enter(ENodeKind::AlternativePart, static_cast<NConditionStmt*>(frame.Node)->AltPart);
+				continue;
+			}
+			break;
+		case ENodeKind::IncompleteConditionStmt:
+			if (child == 0)
+			{
+				Enter(ENodeKind::StmtsList, static_cast<NIncompleteConditionStmt*>(frame.Node)->StmtsList);
+				continue;
+			}
+			break;
+		case ENodeKind::AlternativePart:
+			if (child == 0 && !static_cast<NAlternativePart*>(frame.Node)->Empty)
+			{
+				Enter(ENodeKind::StmtsList, static_cast<NAlternativePart*>(frame.Node)->StmtsList);
+				continue;
+			}
+			break;
+		}
+
+		m_Frames.pop_back();
+		Leave(frame);
+	}
+}
+
+void AST::StatementWalker::Enter(ENodeKind kind, ASTNode* node)
+{
+	if (!IsValid(node))
+	{
+		MissingNode();
+		return;
+	}
+
+	m_Frames.push_back({ kind, node });
+	switch (kind)
+	{
+	case ENodeKind::StmtsList:					EnterStmtsList(static_cast<NStmtsList&>(*node)); break;
+	case ENodeKind::IfStmt:						EnterIfStmt(static_cast<NIfStmt&>(*node)); break;
+	case ENodeKind::ConditionStmt:				EnterConditionStmt(static_cast<NConditionStmt&>(*node)); break;
+	case ENodeKind::IncompleteConditionStmt:	EnterIncompleteConditionStmt(static_cast<NIncompleteConditionStmt&>(*node)); break;
+	case ENodeKind::AlternativePart:			EnterAlternativePart(static_cast<NAlternativePart&>(*node)); break;
+	}
+}
+
+void AST::StatementWalker::Leave(const Frame& frame)
+{
+	switch (frame.Kind)
+	{
+	case ENodeKind::StmtsList:					LeaveStmtsList(static_cast<NStmtsList&>(*frame.Node)); break;
+	case ENodeKind::IfStmt:						LeaveIfStmt(static_cast<NIfStmt&>(*frame.Node)); break;
+	case ENodeKind::ConditionStmt:				LeaveConditionStmt(static_cast<NConditionStmt&>(*frame.Node)); break;
+	case ENodeKind::IncompleteConditionStmt:	LeaveIncompleteConditionStmt(static_cast<NIncompleteConditionStmt&>(*frame.Node)); break;
+	case ENodeKind::AlternativePart:			LeaveAlternativePart(static_cast<NAlternativePart&>(*frame.Node)); break;
+	}
+}
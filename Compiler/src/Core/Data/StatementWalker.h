@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Data/Visitor.h"
+
+#include <vector>
+#include <cstdint>
+
+namespace AST
+{
+	// Visitor that walks the statement part of the tree from a heap stack instead of recursing.
+	// IF statements nest through <statements-list>s, so every node on that cycle is entered and left
+	// by the walk, with the hooks below, and any other statement is accepted whole.
+	// Accepting any node of the cycle starts a walk of it.
+	class StatementWalker : public Visitor
+	{
+	public:
+		virtual void Visit(NStmtsList& node) override final;
+		virtual void Visit(NIfStmt& node) override final;
+		virtual void Visit(NConditionStmt& node) override final;
+		virtual void Visit(NIncompleteConditionStmt& node) override final;
+		virtual void Visit(NAlternativePart& node) override final;
+
+	protected:
+		virtual void EnterStmtsList(NStmtsList& node) {}
+		// Before the statement at 'index' is walked
+		virtual void EnterStmtsListItem(NStmtsList& node, uint32_t index) {}
+		virtual void LeaveStmtsList(NStmtsList& node) {}
+		virtual void EnterIfStmt(NIfStmt& node) {}
+		virtual void LeaveIfStmt(NIfStmt& node) {}
+		virtual void EnterConditionStmt(NConditionStmt& node) {}
+		virtual void LeaveConditionStmt(NConditionStmt& node) {}
+		virtual void EnterIncompleteConditionStmt(NIncompleteConditionStmt& node) {}
+		virtual void LeaveIncompleteConditionStmt(NIncompleteConditionStmt& node) {}
+		virtual void EnterAlternativePart(NAlternativePart& node) {}
+		virtual void LeaveAlternativePart(NAlternativePart& node) {}
+		// In place of a node of the cycle that failed to parse
+		virtual void MissingNode() {}
+
+	private:
+		enum class ENodeKind : uint8_t { StmtsList, IfStmt, ConditionStmt, IncompleteConditionStmt, AlternativePart };
+
+		struct Frame
+		{
+			ENodeKind Kind;
+			ASTNode* Node;
+			uint32_t Next = 0;	// Child to walk next
+		};
+
+		void Walk(ENodeKind kind, ASTNode& node);
+		void Enter(ENodeKind kind, ASTNode* node);
+		void Leave(const Frame& frame);
+
+	private:
+		std::vector<Frame> m_Frames;
+	};
+}
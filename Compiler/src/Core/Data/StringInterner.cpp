@@ -0,0 +1,80 @@
+#include "StringInterner.h"
+#include "Utilities/Hash.h"
+
+static constexpr size_t s_InitialCapacity = 64;
+
+StringInterner::StringInterner()
+{
+	Clear();
+}
+
+uint32_t StringInterner::Intern(std::string_view str)
+{
+	uint32_t hash = Hash(str);
+	size_t slot = FindSlot(str, hash);
+	if (m_Slots[slot].Id != InvalidId)
+		return m_Slots[slot].Id;
+
+	uint32_t id = static_cast<uint32_t>(m_Hashes.size());
+	m_Arena.insert(m_Arena.end(), str.begin(), str.end());
+	m_Offsets.push_back(m_Arena.size());
+	m_Hashes.push_back(hash);
+	m_Slots[slot] = { hash, id };
+
+	if (m_Hashes.size() * 2 > m_Slots.size())
+		Grow();
+	return id;
+}
+
+uint32_t StringInterner::Find(std::string_view str) const
+{
+	return m_Slots[FindSlot(str, Hash(str))].Id;
+}
+
+std::string_view StringInterner::Get(uint32_t id) const
+{
+	return std::string_view(m_Arena.data() + m_Offsets[id], m_Offsets[id + 1] - m_Offsets[id]);
+}
+
+void StringInterner::Clear()
+{
+	m_Arena.clear();
+	m_Offsets.assign(1, 0);
+	m_Hashes.clear();
+
+	m_Slots.assign(s_InitialCapacity, { 0, InvalidId });
+	m_Mask = s_InitialCapacity - 1;
+}
+
+uint32_t StringInterner::Hash(std::string_view str)
+{
+	return static_cast<uint32_t>(HashBytes(str.data(), str.size()));
+}
+
+size_t StringInterner::FindSlot(std::string_view str, uint32_t hash) const
+{
+	size_t slot = hash & m_Mask;
+	for (;;)
+	{
+		const Slot& candidate = m_Slots[slot];
+		if (candidate.Id == InvalidId)
+			return slot;
+		if (candidate.Hash == hash && Get(candidate.Id) == str)
+			return slot;
+		slot = (slot + 1) & m_Mask;
+	}
+}
+
+void StringInterner::Grow()
+{
+	m_Slots.assign(m_Slots.size() * 2, { 0, InvalidId });
+	m_Mask = m_Slots.size() - 1;
+
+	for (uint32_t id = 0; id < m_Hashes.size(); id++)
+	{
+		size_t slot = m_Hashes[id] & m_Mask;
+		while (m_Slots[slot].Id != InvalidId)
+			slot = (slot + 1) & m_Mask;
+		m_Slots[slot] = { m_Hashes[id], id };
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Maps strings to dense 32-bit ids in order of first appearance.
+// All strings live back to back in one arena, the lookup table is open-addressed
+// and keeps each entry's hash so probes rarely touch the arena.
+class StringInterner
+{
+public:
+	static constexpr uint32_t InvalidId = UINT32_MAX;
+
+	StringInterner();
+
+	uint32_t Intern(std::string_view str);
+	uint32_t Find(std::string_view str) const;
+	std::string_view Get(uint32_t id) const;
+
+	size_t Size() const { return m_Hashes.size(); }
+	bool Empty() const { return m_Hashes.empty(); }
+	void Clear();
+
+	static uint32_t Hash(std::string_view str);
+
+private:
+	struct Slot
+	{
+		uint32_t Hash;
+		uint32_t Id;
+	};
+
+	size_t FindSlot(std::string_view str, uint32_t hash) const;
+	void Grow();
+
+private:
+	std::vector<char> m_Arena;
+	std::vector<size_t> m_Offsets;	// Start of every string in the arena, plus the end of the last one
+	std::vector<uint32_t> m_Hashes;
+
+	std::vector<Slot> m_Slots;
+	size_t m_Mask;
+};
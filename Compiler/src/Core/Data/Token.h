@@ -2,6 +2,7 @@
 
 
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 enum class ETokenCode : uint32_t
@@ -31,9 +32,20 @@ enum class ETokenCode : uint32_t
 	KW_ELSE,
 	KW_ENDIF,
 	
+	// Only used to number constants and identifiers in listings, the token itself keeps the table index
 	ConstantBase = 501,	 
 	IdentifierBase = 1001
 };
+
+enum class ETokenKind : uint8_t
+{
+	None = 0,
+	Eof,
+	Delimiter,
+	Keyword,
+	Constant,
+	Identifier
+};
 template <typename T>
 constexpr auto operator+(T e) noexcept
 -> std::enable_if_t<std::is_enum<T>::value, std::underlying_type_t<T>>
@@ -46,8 +58,20 @@ struct Token
 {
 	size_t Line;
 	size_t Position;
-	uint32_t Code;
-	std::string Lexeme;
+	ETokenKind Kind;
+	uint32_t Code;				// ETokenCode, or the table index for constants and identifiers
+	std::string_view Lexeme;	// Points into the SourceBuffer the token was scanned from, a chunked one drops it with the token
+
+	bool IsIdentifier() const { return Kind == ETokenKind::Identifier; }
+	bool IsSymbol() const { return Kind == ETokenKind::Constant || Kind == ETokenKind::Identifier; }
+	bool Is(ETokenCode code) const { return !IsSymbol() && Code == +code; }
 
-	bool IsIdentifier() { return Code > 1001; }
+	uint32_t DisplayCode() const
+	{
+		if (Kind == ETokenKind::Constant)
+			return +ETokenCode::ConstantBase + Code;
+		if (Kind == ETokenKind::Identifier)
+			return +ETokenCode::IdentifierBase + Code;
+		return Code;
+	}
 };
@@ -0,0 +1,192 @@
+#include "TokenStream.h"
+
+#include <algorithm>
+
+static constexpr size_t s_LineIndexStep = 1 << 16;
+
+void TokenStream::SetSource(std::shared_ptr<SourceBuffer> source)
+{
+	Clear();
+	m_Source = source;
+}
+
+void TokenStream::Push(ETokenKind kind, uint32_t code, uint32_t offset, uint32_t length)
+{
+	m_Kinds.push_back(kind);
+	m_Codes.push_back(code);
+	m_Offsets.push_back(offset - m_ShiftDelta);
+	m_Lengths.push_back(length);
+}
+
+void TokenStream::Clear()
+{
+	m_Kinds.clear();
+	m_Codes.clear();
+	m_Offsets.clear();
+	m_Lengths.clear();
+	m_Base = 0;
+	m_ShiftFrom = UINT32_MAX;
+	m_ShiftDelta = 0;
+	m_Pinned.clear();
+	m_Lines.Clear();
+}
+
+void TokenStream::Compact(uint32_t keepFrom)
+{
+	if (keepFrom <= m_Base)
+		return;
+
+	size_t count = std::min<size_t>(keepFrom - m_Base, m_Kinds.size());
+	m_Kinds.erase(m_Kinds.begin(), m_Kinds.begin() + count);
+	m_Codes.erase(m_Codes.begin(), m_Codes.begin() + count);
+	m_Offsets.erase(m_Offsets.begin(), m_Offsets.begin() + count);
+	m_Lengths.erase(m_Lengths.begin(), m_Lengths.begin() + count);
+	m_Base += static_cast<uint32_t>(count);
+}
+
+void TokenStream::SourceEdited(uint32_t offset)
+{
+	m_Lines.Truncate(offset);
+}
+
+// The tokens that take the place of [first, last) are stored as they are, so the pending shift has to start after them
+void TokenStream::Replace(uint32_t first, uint32_t last, const TokenStream& tokens)
+{
+	if (m_ShiftFrom < last)
+		MoveShiftTo(last);
+	if (m_ShiftDelta != 0)
+		m_ShiftFrom = m_ShiftFrom - last + first + tokens.Size();
+
+	auto replace = [first, last](auto& column, const auto& with)
+	{
+		size_t common = std::min<size_t>(last - first, with.size());
+		std::copy(with.begin(), with.begin() + common, column.begin() + first);
+		if (common < with.size())
+			column.insert(column.begin() + last, with.begin() + common, with.end());
+		else
+			column.erase(column.begin() + first + common, column.begin() + last);
+	};
+	replace(m_Kinds, tokens.m_Kinds);
+	replace(m_Codes, tokens.m_Codes);
+	replace(m_Offsets, tokens.m_Offsets);
+	replace(m_Lengths, tokens.m_Lengths);
+}
+
+void TokenStream::Insert(uint32_t index, ETokenKind kind, uint32_t code, uint32_t offset, uint32_t length)
+{
+	if (index < m_ShiftFrom && m_ShiftDelta != 0)
+		m_ShiftFrom++;
+	else if (index >= m_ShiftFrom)
+		offset -= m_ShiftDelta;
+
+	m_Kinds.insert(m_Kinds.begin() + index, kind);
+	m_Codes.insert(m_Codes.begin() + index, code);
+	m_Offsets.insert(m_Offsets.begin() + index, offset);
+	m_Lengths.insert(m_Lengths.begin() + index, length);
+}
+
+void TokenStream::Erase(uint32_t index)
+{
+	if (index < m_ShiftFrom && m_ShiftDelta != 0)
+		m_ShiftFrom--;
+
+	m_Kinds.erase(m_Kinds.begin() + index);
+	m_Codes.erase(m_Codes.begin() + index);
+	m_Offsets.erase(m_Offsets.begin() + index);
+	m_Lengths.erase(m_Lengths.begin() + index);
+}
+
+void TokenStream::ShiftOffsets(uint32_t first, int64_t delta)
+{
+	MoveShiftTo(first);
+	m_ShiftDelta += static_cast<uint32_t>(delta);
+}
+
+// Makes the pending shift start at 'index' instead, the offsets in between take it in or drop it
+void TokenStream::MoveShiftTo(uint32_t index)
+{
+	if (m_ShiftDelta != 0)
+	{
+		for (uint32_t i = index; i < m_ShiftFrom; i++)
+			m_Offsets[i] -= m_ShiftDelta;
+		for (uint32_t i = m_ShiftFrom; i < index; i++)
+			m_Offsets[i] += m_ShiftDelta;
+	}
+	m_ShiftFrom = index;
+}
+
+uint32_t TokenStream::LowerBound(uint32_t offset) const
+{
+	uint32_t low = m_Base;
+	uint32_t high = Size();
+	while (low < high)
+	{
+		uint32_t middle = low + (high - low) / 2;
+		if (Offset(middle) < offset)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+void TokenStream::Pin(uint32_t index, uint32_t offset)
+{
+	if (m_Pinned.empty() || m_Pinned.back().Index < index)
+		m_Pinned.push_back({ index, offset });
+}
+
+std::string_view TokenStream::Lexeme(uint32_t index) const
+{
+	return m_Source->View(Offset(index), Length(index));
+}
+
+SourceLocation TokenStream::Locate(uint32_t offset) const
+{
+	// Index ahead in large steps, diagnostics tend to come in order
+	if (offset >= m_Lines.Scanned())
+		IndexLines(static_cast<size_t>(offset) + s_LineIndexStep);
+	return m_Lines.Locate(offset);
+}
+
+uint32_t TokenStream::StartOffset(uint32_t index) const
+{
+	if (index >= m_Base && index < Size())
+		return Offset(index);
+
+	auto pin = std::lower_bound(m_Pinned.begin(), m_Pinned.end(), index, [](const PinnedToken& pinned, uint32_t wanted) { return pinned.Index < wanted; });
+	if (pin == m_Pinned.end() || pin->Index != index)
+		return 0;
+	return pin->Offset;
+}
+
+void TokenStream::IndexLines(size_t upTo) const
+{
+	upTo = std::min<size_t>(upTo, m_Source->First() + m_Source->Size());
+	// An edited source is contiguous on either side of its gap
+	size_t gap = m_Source->GapAt();
+	if (m_Lines.Scanned() < gap && gap < upTo)
+		m_Lines.Extend(m_Source->At(m_Lines.Scanned()), m_Source->At(m_Lines.Scanned()) + (gap - m_Lines.Scanned()));
+	if (upTo > m_Lines.Scanned())
+		m_Lines.Extend(m_Source->At(m_Lines.Scanned()), m_Source->At(m_Lines.Scanned()) + (upTo - m_Lines.Scanned()));
+}
+
+Token TokenStream::At(uint32_t index) const
+{
+	// Eof of a file without tokens has nothing in the source to point at
+	if (Kind(index) == ETokenKind::Eof && index == 0)
+		return { 1, 1, ETokenKind::Eof, +ETokenCode::Eof, " " };
+
+	SourceLocation location = Locate(Offset(index));
+	return { location.Line, location.Position, Kind(index), Code(index), Lexeme(index) };
+}
+
+// Anything between the two is counted in, they are merged into one range
+TokenDamage TokenDamage::Combine(const TokenDamage& next) const
+{
+	TokenDamage combined;
+	combined.First = std::min(First, next.First);
+	combined.OldEnd = NewEnd >= next.OldEnd ? OldEnd : static_cast<uint32_t>(next.OldEnd - Shift());
+	combined.NewEnd = next.OldEnd >= NewEnd ? next.NewEnd : static_cast<uint32_t>(NewEnd + next.Shift());
+	return combined;
+}
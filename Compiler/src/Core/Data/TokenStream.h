@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Data/Token.h"
+#include "Data/LineIndex.h"
+#include "Data/SourceBuffer.h"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// Tokens of one source file, stored column-wise so the parser only touches kinds and codes.
+// Lexemes and line/position pairs are recovered from the offsets when someone asks for them.
+// Indices are absolute: after Compact() the stream only holds [First(), Size()), but the indices stay the same.
+// Offsets are 32-bit, no source is larger than SourceBuffer::MaxSize.
+class TokenStream
+{
+public:
+	static constexpr uint32_t InvalidIndex = UINT32_MAX;
+	static_assert(SourceBuffer::MaxSize < UINT32_MAX, "The end of the last token has to fit an offset");
+
+	void SetSource(std::shared_ptr<SourceBuffer> source);
+	void Push(ETokenKind kind, uint32_t code, uint32_t offset, uint32_t length);
+	void Clear();
+	// Drops every token before 'keepFrom'
+	void Compact(uint32_t keepFrom);
+
+	// Editing in place, for incremental relexing. Not for streams that were compacted
+	void SourceEdited(uint32_t offset);	// The text changed from 'offset' on, offsets of the tokens after it must be fixed up to match
+	void Replace(uint32_t first, uint32_t last, const TokenStream& tokens);	// [first, last) becomes all of 'tokens', which has no shift pending
+	void Insert(uint32_t index, ETokenKind kind, uint32_t code, uint32_t offset, uint32_t length);
+	void Erase(uint32_t index);
+	void SetCode(uint32_t index, uint32_t code) { m_Codes[index - m_Base] = code; }
+	// Only records the shift. Offset() adds it in, and it is applied to the tokens in between when a later edit is elsewhere,
+	// so a series of edits close to each other doesn't touch the offsets of the rest of the stream
+	void ShiftOffsets(uint32_t first, int64_t delta);
+	// First token that starts at or after 'offset', Size() if there is none
+	uint32_t LowerBound(uint32_t offset) const;
+
+	// Keeps where token 'index' starts past Compact(), so nodes that refer to it can still be located.
+	// Pins come in increasing order of index. The second form pins a token the stream never held, such as one from an ASTImage
+	void Pin(uint32_t index) { Pin(index, Offset(index)); }
+	void Pin(uint32_t index, uint32_t offset);
+
+	uint32_t First() const { return m_Base; }
+	uint32_t Size() const { return m_Base + static_cast<uint32_t>(m_Kinds.size()); }
+	bool Empty() const { return Size() == 0; }
+
+	ETokenKind Kind(uint32_t index) const { return m_Kinds[index - m_Base]; }
+	uint32_t Code(uint32_t index) const { return m_Codes[index - m_Base]; }
+	uint32_t Offset(uint32_t index) const { return m_Offsets[index - m_Base] + (index >= m_ShiftFrom ? m_ShiftDelta : 0); }
+	uint32_t Length(uint32_t index) const { return m_Lengths[index - m_Base]; }
+
+	bool IsSymbol(uint32_t index) const { return Kind(index) == ETokenKind::Constant || Kind(index) == ETokenKind::Identifier; }
+	bool Is(uint32_t index, ETokenCode code) const { return !IsSymbol(index) && Code(index) == +code; }
+
+	std::string_view Lexeme(uint32_t index) const;
+	SourceLocation Locate(uint32_t offset) const;
+	// Where token 'index' starts, for tokens in the stream and pinned ones
+	uint32_t StartOffset(uint32_t index) const;
+	SourceLocation Location(uint32_t index) const { return Locate(StartOffset(index)); }
+	// Locate() indexes lines on demand, a chunked source has to be indexed before its text is dropped
+	void IndexLines(size_t upTo) const;
+
+	// Materializes a single token, for diagnostics and listings
+	Token At(uint32_t index) const;
+
+private:
+	void MoveShiftTo(uint32_t index);
+
+private:
+	std::vector<ETokenKind> m_Kinds;
+	std::vector<uint32_t> m_Codes;
+	std::vector<uint32_t> m_Offsets;
+	std::vector<uint32_t> m_Lengths;
+	uint32_t m_Base = 0;
+
+	// Offsets from m_ShiftFrom on are stored without the m_ShiftDelta that ShiftOffsets() hasn't applied yet.
+	// Both wrap around like the offsets do
+	uint32_t m_ShiftFrom = UINT32_MAX;
+	uint32_t m_ShiftDelta = 0;
+
+	struct PinnedToken
+	{
+		uint32_t Index;
+		uint32_t Offset;
+	};
+	std::vector<PinnedToken> m_Pinned;
+
+	std::shared_ptr<SourceBuffer> m_Source;
+	mutable LineIndex m_Lines;
+};
+
+// Tokens [First, OldEnd) of a stream were replaced by [First, NewEnd), the ones after it only moved by Shift()
+struct TokenDamage
+{
+	uint32_t First = 0;
+	uint32_t OldEnd = 0;
+	uint32_t NewEnd = 0;
+
+	bool Empty() const { return OldEnd == First && NewEnd == First; }
+	int64_t Shift() const { return static_cast<int64_t>(NewEnd) - OldEnd; }
+	// This damage followed by 'next', which is given in terms of the stream this one left
+	TokenDamage Combine(const TokenDamage& next) const;
+};
+
+// Something that appends tokens to a TokenStream on request
+class TokenSource
+{
+public:
+	virtual ~TokenSource() = default;
+
+	// Appends at least 'count' tokens, fewer only when the input runs out.
+	// Returns false once the Eof token has been appended
+	virtual bool ScanNext(uint32_t count) = 0;
+};
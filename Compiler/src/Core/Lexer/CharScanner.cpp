@@ -0,0 +1,238 @@
+#include "CharScanner.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#define CHAR_SCANNER_X64
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+		#define TARGET_AVX2
+	#else
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+namespace
+{
+	enum class ECharClass : uint8_t
+	{
+		WhiteSpace,
+		Identifier,
+		Digit
+	};
+
+	// Must stay in sync with Lexer::SetupSymbolCategories
+	template <ECharClass Class>
+	inline bool IsInClass(unsigned char c)
+	{
+		if constexpr (Class == ECharClass::WhiteSpace)
+			return (c >= 8 && c <= 13) || c == ' ';
+		else if constexpr (Class == ECharClass::Digit)
+			return c >= '0' && c <= '9';
+		else
+			return (c >= '0' && c <= '9') || (c >= '@' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
+	}
+
+	template <ECharClass Class>
+	const char* ScanScalar(const char* p, const char* end)
+	{
+		while (p != end && IsInClass<Class>(static_cast<unsigned char>(*p)))
+			p++;
+		return p;
+	}
+
+	const char* FindCommentEndScalar(const char* begin, const char* end, bool bStarBefore)
+	{
+		const char* p = begin;
+		while (const void* found = std::memchr(p, ')', end - p))
+		{
+			const char* paren = static_cast<const char*>(found);
+			if (paren != begin ? paren[-1] == '*' : bStarBefore)
+				return paren;
+			p = paren + 1;
+		}
+		return end;
+	}
+
+#ifdef CHAR_SCANNER_X64
+
+	// Signed compares are fine here: every class lies in [0, 127], bytes >= 128 compare as negative
+	inline __m128i InRange128(__m128i v, char lo, char hi)
+	{
+		return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+	}
+
+	template <ECharClass Class>
+	inline __m128i Classify128(__m128i v)
+	{
+		if constexpr (Class == ECharClass::WhiteSpace)
+			return _mm_or_si128(InRange128(v, 8, 13), _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+		else if constexpr (Class == ECharClass::Digit)
+			return InRange128(v, '0', '9');
+		else
+		{
+			__m128i upper = _mm_or_si128(InRange128(v, '0', '9'), InRange128(v, '@', 'Z'));
+			__m128i lower = _mm_or_si128(InRange128(v, 'a', 'z'), _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+			return _mm_or_si128(upper, lower);
+		}
+	}
+
+	template <ECharClass Class>
+	const char* ScanSSE2(const char* p, const char* end)
+	{
+		while (end - p >= 16)
+		{
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			uint32_t outside = ~static_cast<uint32_t>(_mm_movemask_epi8(Classify128<Class>(block))) & 0xFFFFu;
+			if (outside)
+				return p + std::countr_zero(outside);
+			p += 16;
+		}
+		return ScanScalar<Class>(p, end);
+	}
+
+	const char* FindCommentEndSSE2(const char* begin, const char* end, bool bStarBefore)
+	{
+		const char* p = begin;
+		uint32_t carry = bStarBefore;
+		while (end - p >= 16)
+		{
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			uint32_t stars = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('*'))));
+			uint32_t parens = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(')'))));
+			uint32_t closes = ((stars << 1) | carry) & parens;
+			if (closes)
+				return p + std::countr_zero(closes);
+			carry = stars >> 15;
+			p += 16;
+		}
+		return FindCommentEndScalar(p, end, carry != 0);
+	}
+
+	TARGET_AVX2 inline __m256i InRange256(__m256i v, char lo, char hi)
+	{
+		return _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8(lo - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), v));
+	}
+
+	template <ECharClass Class>
+	TARGET_AVX2 inline __m256i Classify256(__m256i v)
+	{
+		if constexpr (Class == ECharClass::WhiteSpace)
+			return _mm256_or_si256(InRange256(v, 8, 13), _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+		else if constexpr (Class == ECharClass::Digit)
+			return InRange256(v, '0', '9');
+		else
+		{
+			__m256i upper = _mm256_or_si256(InRange256(v, '0', '9'), InRange256(v, '@', 'Z'));
+			__m256i lower = _mm256_or_si256(InRange256(v, 'a', 'z'), _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_')));
+			return _mm256_or_si256(upper, lower);
+		}
+	}
+
+	template <ECharClass Class>
+	TARGET_AVX2 const char* ScanAVX2(const char* p, const char* end)
+	{
+		while (end - p >= 32)
+		{
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			uint32_t outside = ~static_cast<uint32_t>(_mm256_movemask_epi8(Classify256<Class>(block)));
+			if (outside)
+				return p + std::countr_zero(outside);
+			p += 32;
+		}
+		return ScanSSE2<Class>(p, end);
+	}
+
+	TARGET_AVX2 const char* FindCommentEndAVX2(const char* begin, const char* end, bool bStarBefore)
+	{
+		const char* p = begin;
+		uint32_t carry = bStarBefore;
+		while (end - p >= 32)
+		{
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+			uint32_t stars = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('*'))));
+			uint32_t parens = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(')'))));
+			uint32_t closes = ((stars << 1) | carry) & parens;
+			if (closes)
+				return p + std::countr_zero(closes);
+			carry = stars >> 31;
+			p += 32;
+		}
+		return FindCommentEndSSE2(p, end, carry != 0);
+	}
+
+	bool HasAVX2()
+	{
+	#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+	#else
+		return __builtin_cpu_supports("avx2");
+	#endif
+	}
+
+#endif
+
+	using ScanFunction = const char* (*)(const char*, const char*);
+	using CommentFunction = const char* (*)(const char*, const char*, bool);
+
+	struct ScanDispatch
+	{
+		ScanFunction WhiteSpace;
+		ScanFunction Identifier;
+		ScanFunction Digits;
+		CommentFunction CommentEnd;
+	};
+
+	const ScanDispatch& GetDispatch()
+	{
+		static const ScanDispatch dispatch = []() -> ScanDispatch
+		{
+		#ifdef CHAR_SCANNER_X64
+			if (HasAVX2())
+				return { ScanAVX2<ECharClass::WhiteSpace>, ScanAVX2<ECharClass::Identifier>, ScanAVX2<ECharClass::Digit>, FindCommentEndAVX2 };
+			return { ScanSSE2<ECharClass::WhiteSpace>, ScanSSE2<ECharClass::Identifier>, ScanSSE2<ECharClass::Digit>, FindCommentEndSSE2 };
+		#else
+			return { ScanScalar<ECharClass::WhiteSpace>, ScanScalar<ECharClass::Identifier>, ScanScalar<ECharClass::Digit>, FindCommentEndScalar };
+		#endif
+		}();
+		return dispatch;
+	}
+}
+
+namespace CharScanner
+{
+	const char* SkipWhiteSpace(const char* begin, const char* end)
+	{
+		return GetDispatch().WhiteSpace(begin, end);
+	}
+
+	const char* SkipIdentifier(const char* begin, const char* end)
+	{
+		return GetDispatch().Identifier(begin, end);
+	}
+
+	const char* SkipDigits(const char* begin, const char* end)
+	{
+		return GetDispatch().Digits(begin, end);
+	}
+
+	const char* FindCommentEnd(const char* begin, const char* end)
+	{
+		return GetDispatch().CommentEnd(begin, end, false);
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+// Finds the end of a run of same-class characters.
+// Every function returns the first position in [begin, end) that is not part of the run, or end.
+// The vector width is picked once at startup: AVX2 when the CPU supports it, SSE2 otherwise.
+namespace CharScanner
+{
+	// Must stay in sync with Lexer::SetupSymbolCategories
+	inline bool IsWhiteSpace(char c)
+	{
+		return (c >= 8 && c <= 13) || c == ' ';
+	}
+
+	const char* SkipWhiteSpace(const char* begin, const char* end);
+	const char* SkipIdentifier(const char* begin, const char* end);
+	const char* SkipDigits(const char* begin, const char* end);
+
+	// Returns the ')' of the first "*)" whose '*' lies in [begin, end), or end if the comment is not closed
+	const char* FindCommentEnd(const char* begin, const char* end);
+}
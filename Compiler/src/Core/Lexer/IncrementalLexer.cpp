@@ -0,0 +1,163 @@
+#include "IncrementalLexer.h"
+#include "CharScanner.h"
+#include "Errors/ErrorHandler.h"
+
+#include <algorithm>
+
+// How much of the text after an edit is made contiguous for relexing it. Lexing lines up again within a few tokens,
+// only an edit that changes how the rest of the source lexes, such as one that opens a comment, needs all of it
+static constexpr uint32_t s_RelexWindow = 1 << 12;
+
+IncrementalLexer::IncrementalLexer(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler)
+	: m_Context(context), m_ErrorHandler(errorHandler)
+{
+}
+
+void IncrementalLexer::SetEngine(ELexerEngine engine)
+{
+	m_Engine = engine;
+}
+
+bool IncrementalLexer::Open(const std::string& filePath)
+{
+	auto source = std::make_shared<SourceBuffer>();
+	if (!source->Open(filePath))
+	{
+		auto error = ErrorHandler::CreateGeneralError(source->GetOpenError(), EErrorInstigator::FileIO);
+		m_ErrorHandler->ReportError(error);
+		m_ErrorHandler->GotFatalError();
+		return false;
+	}
+	m_Context->Source = source;
+	m_Context->Tokens->SetSource(source);
+	m_Errors.clear();
+	m_LastRelexed = 0;
+	m_LastDamage = {};
+
+	LexFrom(0, 0, static_cast<uint32_t>(source->Size()), {});
+	return true;
+}
+
+void IncrementalLexer::Relex(const std::vector<TextEdit>& edits)
+{
+	m_LastRelexed = 0;
+	m_LastDamage = {};
+	for (size_t i = 0; i < edits.size(); i++)
+	{
+		TokenDamage damage = Apply(edits[i]);
+		m_LastDamage = i == 0 ? damage : m_LastDamage.Combine(damage);
+	}
+}
+
+void IncrementalLexer::ReportErrors()
+{
+	for (const auto& [offset, message] : m_Errors)
+	{
+		SourceLocation location = m_Context->Tokens->Locate(offset);
+		auto error = ErrorHandler::CreateSyntaxError(message, location.Line, location.Position, EErrorInstigator::Lexer);
+		m_ErrorHandler->ReportError(error);
+	}
+}
+
+TokenDamage IncrementalLexer::Apply(const TextEdit& edit)
+{
+	SourceBuffer& source = *m_Context->Source;
+	uint32_t editBegin = static_cast<uint32_t>(std::min<size_t>(edit.Offset, source.Size()));
+	uint32_t editEnd = static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(editBegin) + edit.RemovedLength, source.Size()));
+	int64_t shift = static_cast<int64_t>(edit.Inserted.size()) - (editEnd - editBegin);
+
+	TokenStream& tokens = *m_Context->Tokens;
+	uint32_t previousEof = m_EofIndex;
+	uint32_t previousSize = tokens.Size();
+	tokens.Erase(m_EofIndex);
+
+	// Keep the tokens that end before the edit. A token ending right at it could grow, and ends are ordered like starts
+	uint32_t first = tokens.LowerBound(editBegin);
+	while (first > 0 && tokens.Offset(first - 1) + tokens.Length(first - 1) >= editBegin)
+		first--;
+	uint32_t begin = first > 0 ? tokens.Offset(first - 1) + tokens.Length(first - 1) : 0;
+
+	source.Edit(editBegin, editEnd - editBegin, edit.Inserted);
+	tokens.SourceEdited(editBegin);
+	uint32_t windowEnd = WindowEnd(editBegin + static_cast<uint32_t>(edit.Inserted.size()));
+	TokenDamage damage = LexFrom(first, begin, windowEnd, { &tokens, tokens.LowerBound(editEnd), shift });
+
+	// That was without the Eof token. Unless it stays after the damage with the tokens it came before, all of the end counts
+	if (damage.OldEnd >= previousEof)
+		damage = { std::min({ damage.First, previousEof, m_EofIndex }), previousSize, tokens.Size() };
+	return damage;
+}
+
+// First character after 'from' plus the window that follows whitespace, the end of the source if there is none
+uint32_t IncrementalLexer::WindowEnd(uint32_t from) const
+{
+	const SourceBuffer& source = *m_Context->Source;
+	size_t end = std::min<size_t>(static_cast<size_t>(from) + s_RelexWindow, source.Size());
+	while (end < source.Size() && !CharScanner::IsWhiteSpace(*source.At(end - 1)))
+		end++;
+	return static_cast<uint32_t>(end);
+}
+
+// Lexes the source from 'begin' on in place of the tokens from 'first' on, until it lines up with 'resync'.
+// Only the text up to 'end' is made contiguous for the lexer, unless it doesn't line up before that.
+// Returns the tokens it replaced, as the stream is without its Eof token
+TokenDamage IncrementalLexer::LexFrom(uint32_t first, uint32_t begin, uint32_t end, const ResyncTarget& resync)
+{
+	TokenStream& tokens = *m_Context->Tokens;
+	SourceBuffer& source = *m_Context->Source;
+
+	LexerChunk chunk;
+	for (;;)
+	{
+		chunk = LexerChunk();
+		chunk.Context = std::make_shared<CompilationContext>();
+		source.MoveGap(end);
+		Lexer lexer(chunk.Context, m_ErrorHandler);
+		lexer.SetEngine(m_Engine);
+		lexer.ScanChunk(m_Context->Source, begin, end, false, chunk, resync);
+		// Such as for an edit that opens a comment
+		if (chunk.ResyncIndex != LexerChunk::NoResync || end == source.Size())
+			break;
+		end = static_cast<uint32_t>(source.Size());
+	}
+	chunk.MoveSymbolsTo(*m_Context, 0);
+
+	bool bLinedUp = chunk.ResyncIndex != LexerChunk::NoResync;
+	uint32_t last = bLinedUp ? chunk.ResyncIndex : tokens.Size();
+	const TokenStream& relexed = *chunk.Context->Tokens;
+
+	// Errors are still at their old offsets past the relexed text, the ones in it are replaced
+	uint32_t keptFrom = bLinedUp ? tokens.Offset(last) : UINT32_MAX;
+	auto byOffset = [](const std::pair<uint32_t, std::string>& error, uint32_t offset) { return error.first < offset; };
+	auto damagedBegin = std::lower_bound(m_Errors.begin(), m_Errors.end(), begin, byOffset);
+	auto damagedEnd = std::lower_bound(damagedBegin, m_Errors.end(), keptFrom, byOffset);
+	for (auto it = damagedEnd; it != m_Errors.end(); ++it)
+		it->first = static_cast<uint32_t>(it->first + resync.Shift);
+
+	if (chunk.bEndsInComment)
+		chunk.Errors.emplace_back(chunk.OpenComment, "Comment not closed");
+	damagedBegin = m_Errors.erase(damagedBegin, damagedEnd);
+	m_Errors.insert(damagedBegin, std::make_move_iterator(chunk.Errors.begin()), std::make_move_iterator(chunk.Errors.end()));
+
+	tokens.Replace(first, last, relexed);
+	tokens.ShiftOffsets(first + relexed.Size(), resync.Shift);
+
+	if (bLinedUp)
+		m_EofIndex = m_EofIndex - (last - first) + relexed.Size();
+	else
+		m_EofIndex = first + chunk.EofIndex;
+	PlaceEof();
+
+	m_LastRelexed += relexed.Size();
+	return { first, last, first + relexed.Size() };
+}
+
+// Same Eof the sequential lexer pushes: at the last token, before any token finished by reaching the end of the source
+void IncrementalLexer::PlaceEof()
+{
+	TokenStream& tokens = *m_Context->Tokens;
+	if (m_EofIndex == 0)
+		tokens.Insert(0, ETokenKind::Eof, +ETokenCode::Eof, 0, 0);
+	else
+		tokens.Insert(m_EofIndex, ETokenKind::Eof, +ETokenCode::Eof, tokens.Offset(m_EofIndex - 1), tokens.Length(m_EofIndex - 1));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Lexer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct TextEdit
+{
+	uint32_t Offset;		// Into the text as the edits before this one left it
+	uint32_t RemovedLength;
+	std::string Inserted;
+};
+
+// Keeps a context's source and tokens up to date with edits, relexing only around each one.
+// Lexing restarts right after the last token that ends before the edit and stops at the first token that lines up
+// with one after it, so the lexing work follows the size of the edit. The source is edited in place and tokens after
+// the edit only get a pending shift of their offsets, both cost about as much as the edit is far from the one before.
+// A change in the number of tokens still moves the token columns after it, which is one memmove per column.
+// Symbol tables only grow: ids of untouched tokens stay the same, symbols that are no longer used keep their ids.
+// Lexer errors are kept here with their offsets, ReportErrors() hands the current ones to the error handler
+class IncrementalLexer
+{
+public:
+	IncrementalLexer(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler);
+
+	void SetEngine(ELexerEngine engine);
+
+	bool Open(const std::string& filePath);
+	// Edits are applied in order
+	void Relex(const std::vector<TextEdit>& edits);
+	void ReportErrors();
+
+	uint32_t LastRelexedTokens() const { return m_LastRelexed; }
+	// Where the tokens changed over the last Relex(), for reparsing
+	const TokenDamage& LastDamage() const { return m_LastDamage; }
+
+private:
+	TokenDamage Apply(const TextEdit& edit);
+	uint32_t WindowEnd(uint32_t from) const;
+	TokenDamage LexFrom(uint32_t first, uint32_t begin, uint32_t end, const ResyncTarget& resync);
+	void PlaceEof();
+
+private:
+	std::shared_ptr<CompilationContext> m_Context;
+	std::shared_ptr<ErrorHandler> m_ErrorHandler;
+	ELexerEngine m_Engine = ELexerEngine::StateMachine;
+
+	std::vector<std::pair<uint32_t, std::string>> m_Errors;	// Source offset and message, in source order
+	uint32_t m_EofIndex = 0;
+	uint32_t m_LastRelexed = 0;
+	TokenDamage m_LastDamage;
+};
@@ -1,31 +1,119 @@
 #include "Lexer.h"
 #include "Errors/ErrorHandler.h"
-#include "Data/SymbolTables.h"
+#include "Data/Keywords.h"
+#include "CharScanner.h"
+#include "LexerTable.h"
+#include "ParallelLexer.h"
+
 #include <utility>
 
+// Constants are stored as DWORD
+static constexpr uint64_t s_MaxConstant = UINT32_MAX;
 
-Lexer::Lexer(std::shared_ptr<std::vector<Token>>& tokenSequence, std::shared_ptr<ErrorHandler> errorHandler)
-	: m_Line(1), m_Position(0), m_CurrentCharacter(0), m_ErrorHandler(errorHandler), m_Instigator(EErrorInstigator::Lexer), m_TokenSequence(tokenSequence)
+// Returns false if the digits overflow 64 bits, 'value' then saturates
+static bool ParseDecimal(const char* begin, const char* end, uint64_t& value)
+{
+	value = 0;
+	for (const char* p = begin; p != end; p++)
+	{
+		uint64_t digit = static_cast<uint64_t>(*p - '0');
+		if (value > (UINT64_MAX - digit) / 10)
+		{
+			value = UINT64_MAX;
+			return false;
+		}
+		value = value * 10 + digit;
+	}
+	return true;
+}
+
+
+void LexerChunk::MoveSymbolsTo(CompilationContext& context, uint32_t first)
+{
+	std::vector<uint32_t> constants(Context->Constants.Size(), UINT32_MAX);
+	std::vector<uint32_t> identifiers(Context->Identifiers.Size(), UINT32_MAX);
+
+	TokenStream& tokens = *Context->Tokens;
+	for (uint32_t i = first; i < tokens.Size(); i++)
+	{
+		uint32_t code = tokens.Code(i);
+		if (tokens.Kind(i) == ETokenKind::Constant)
+		{
+			if (constants[code] == UINT32_MAX)
+				constants[code] = context.Constants.Intern(Context->Constants.Get(code));
+			tokens.SetCode(i, constants[code]);
+		}
+		else if (tokens.Kind(i) == ETokenKind::Identifier)
+		{
+			if (identifiers[code] == UINT32_MAX)
+				identifiers[code] = context.Identifiers.Intern(Context->Identifiers.Get(code));
+			tokens.SetCode(i, identifiers[code]);
+		}
+	}
+}
+
+
+Lexer::Lexer(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler)
+	: m_Cursor(nullptr), m_End(nullptr), m_Engine(ELexerEngine::StateMachine), m_CurrentCharacter(0), m_CurrentSymbol(ESymbolCategories::None),
+	m_Context(context), m_TokenSequence(context->Tokens), m_Chunk(nullptr), m_ResyncCursor(0), m_OpenComment(LexerChunk::NoComment),
+	m_ErrorHandler(errorHandler), m_Instigator(EErrorInstigator::Lexer)
 {
 	SetupSymbolCategories();
-	SetupKeywordTable();
 }
 
 
-void Lexer::Scan(const std::string& filePath)
+void Lexer::Scan(const std::string& filePath, uint32_t threadCount)
+{
+	if (!Open(filePath))
+		return;
+
+	if (threadCount > 1 && !m_Source->HasMore() && m_Source->Size() >= ParallelLexer::MinSourceSize)
+	{
+		ParallelLexer parallelLexer(m_Context, m_ErrorHandler, m_Engine);
+		parallelLexer.Scan(m_Source, threadCount);
+	}
+	else
+	{
+		while (ScanNext(UINT32_MAX));
+	}
+}
+
+bool Lexer::Open(const std::string& filePath)
 {
-	m_InputFile.open(filePath);
-	if (!m_InputFile.is_open())
+	m_Source = std::make_shared<SourceBuffer>();
+	m_Context->Source = m_Source;
+	if (!m_Source->OpenChunked(filePath))
 	{
-		auto error = ErrorHandler::CreateGeneralError(std::string("No such file or directory: ") + filePath, EErrorInstigator::FileIO);
+		auto error = ErrorHandler::CreateGeneralError(m_Source->GetOpenError(), EErrorInstigator::FileIO);
 		m_ErrorHandler->ReportError(error);
 		m_ErrorHandler->GotFatalError();
-		return;
+		return false;
 	}
+	m_TokenSequence->SetSource(m_Source);
+	m_OpenComment = LexerChunk::NoComment;
+	m_Cursor = m_Source->Begin();
+	m_End = FindSeam();
 	Next();
+	return true;
+}
 
-	while (m_CurrentSymbol != ESymbolCategories::End)
+bool Lexer::ScanNext(uint32_t count)
+{
+	if (m_Engine == ELexerEngine::Table)
+		return ScanNextTable(count);
+
+	uint64_t target = static_cast<uint64_t>(m_TokenSequence->Size()) + count;
+	while (m_TokenSequence->Size() < target)
 	{
+		if (m_CurrentSymbol == ESymbolCategories::End)
+		{
+			if (!Refill())
+				break;
+			continue;
+		}
+		if (m_Resync.Tokens && AtResyncPoint())
+			return false;
+
 		switch (m_CurrentSymbol)
 		{
 		case ESymbolCategories::WhiteSpace:
@@ -47,51 +135,231 @@ void Lexer::Scan(const std::string& filePath)
 			CommentState();
 			break;
 		default:
-			auto error = ErrorHandler::CreateSyntaxError(std::string("Illegal character '") + m_CurrentCharacter + "' found", m_Line, m_Position, m_Instigator);
-			m_ErrorHandler->ReportError(error);
+			ReportSyntaxError(std::string("Illegal character '") + m_CurrentCharacter + "' found", Current());
 			Next();
 			break;
 		}
 
 	}
-	m_InputFile.close();
+	return m_CurrentSymbol != ESymbolCategories::End || m_Source->HasMore();
+}
 
-	ReverseTables();
+// Same tokens and errors as the state machine above, see LexerTable.
+// Between tokens the lexer is left exactly as the state machine leaves it, so both can pick up where the other stopped
+bool Lexer::ScanNextTable(uint32_t count)
+{
+	uint64_t target = static_cast<uint64_t>(m_TokenSequence->Size()) + count;
+	while (m_TokenSequence->Size() < target)
+	{
+		if (m_CurrentSymbol == ESymbolCategories::End)
+		{
+			if (!Refill())
+				break;
+			continue;
+		}
+		if (m_Resync.Tokens && AtResyncPoint())
+			return false;
+
+		const char* lexemeStart = Current();
+		const char* p = lexemeStart;
+		uint8_t state = LexerTable::Start;
+		while (p != m_End)
+		{
+			state = LexerTable::Transitions[state][LexerTable::Classes[static_cast<unsigned char>(*p++)]];
+			if (state >= LexerTable::FirstAccept)
+				break;
+		}
+
+		if (state < LexerTable::FirstAccept)
+			state = LexerTable::Transitions[state][LexerTable::End];
+		else if (state < LexerTable::FirstInclusiveAccept)
+			p--;
+		SkipTo(p);
+
+		switch (state)
+		{
+		case LexerTable::AcceptIdentifier:
+			PushIdentifier(lexemeStart);
+			break;
+		case LexerTable::AcceptConstant:
+			PushConstant(lexemeStart, nullptr);
+			break;
+		case LexerTable::AcceptSuffixedConstant:
+			PushConstant(lexemeStart, CharScanner::SkipDigits(lexemeStart, p));
+			break;
+		case LexerTable::AcceptDelimiter:
+		case LexerTable::AcceptColon:
+			PushToken(ETokenKind::Delimiter, static_cast<uint32_t>(*lexemeStart), lexemeStart);
+			break;
+		case LexerTable::AcceptAssign:
+			PushToken(ETokenKind::Delimiter, +ETokenCode::DelimiterAssign, lexemeStart);
+			break;
+		case LexerTable::AcceptMissingStar:
+			ReportSyntaxError("Missing '*' after '(' in comment", lexemeStart);
+			break;
+		case LexerTable::AcceptOpenComment:
+			ReportOpenComment(OffsetOf(lexemeStart));
+			break;
+		case LexerTable::AcceptIllegal:
+			ReportSyntaxError(std::string("Illegal character '") + *lexemeStart + "' found", lexemeStart);
+			break;
+		default:
+			break;
+		}
+	}
+	return m_CurrentSymbol != ESymbolCategories::End || m_Source->HasMore();
 }
 
-std::shared_ptr<LexerData> Lexer::GetLexerData()
+void Lexer::SetEngine(ELexerEngine engine)
 {
-	return std::make_shared<LexerData>( m_TokenSequence, ConstantsTable, IdentifiersTable, KeyWordsTable);
+	m_Engine = engine;
 }
 
-void Lexer::Next()
+void Lexer::ScanChunk(std::shared_ptr<SourceBuffer> source, uint32_t begin, uint32_t end, bool bInComment, LexerChunk& chunk,
+	const ResyncTarget& resync)
 {
-	m_CurrentCharacter = m_InputFile.get();
-	if (m_CurrentCharacter == '\n')
-	{
-		m_Line++;
-		m_Position = 0;
-	}
-	else if (m_CurrentCharacter == '\t')
-	{
-		m_Position += 4;
-	}
+	m_Source = source;
+	m_Context->Source = m_Source;
+	m_TokenSequence->SetSource(m_Source);
+	m_Chunk = &chunk;
+	m_Resync = resync;
+	m_ResyncCursor = resync.First;
+
+	m_Cursor = m_Source->Begin() + begin;
+	m_End = m_Source->Begin() + end;
+	if (bInComment)
+		InCommentState(LexerChunk::NoComment);
 	else
+		Next();
+
+	while (ScanNext(UINT32_MAX));
+}
+
+// A chunked source is lexed up to the end of its last whitespace character, so only a comment can cross into the next chunk
+const char* Lexer::FindSeam() const
+{
+	if (!m_Source->HasMore())
+		return m_Source->End();
+
+	const char* seam = m_Source->End();
+	for (; seam > m_Cursor; seam--)
 	{
-		m_Position++;
+		unsigned char symbol = static_cast<unsigned char>(seam[-1]);
+		if (symbol < m_Attributes.size() && m_Attributes[symbol] == ESymbolCategories::WhiteSpace)
+			break;
 	}
-	if (m_CurrentCharacter != EOF)
+	return seam;
+}
+
+// Reads on once the lexer stopped at a seam. Text of the tokens still held stays, lines of what goes are indexed first
+bool Lexer::Refill()
+{
+	if (!m_Source->HasMore())
+		return false;
+
+	uint32_t resumeAt = OffsetOf(m_Cursor);
+	uint32_t keepFrom = m_TokenSequence->First() < m_TokenSequence->Size() ? m_TokenSequence->Offset(m_TokenSequence->First()) : resumeAt;
+	m_TokenSequence->IndexLines(resumeAt);
+	do
+	{
+		m_Source->ReadMore(keepFrom);
+		m_Cursor = m_Source->At(resumeAt);
+		m_End = FindSeam();
+	} while (m_Cursor == m_End && m_Source->HasMore());
+
+	// The source turned out too large while streaming, the rest isn't lexed
+	if (m_Source->IsTooLarge())
 	{
-		m_CurrentSymbol = m_Attributes[m_CurrentCharacter];
+		auto error = ErrorHandler::CreateGeneralError(m_Source->GetOpenError(), EErrorInstigator::FileIO);
+		m_ErrorHandler->ReportError(error);
+		m_ErrorHandler->GotFatalError();
+		m_Cursor = m_End = m_Source->End();
+		m_OpenComment = LexerChunk::NoComment;
 	}
+
+	m_CurrentSymbol = ESymbolCategories::None;
+	if (m_OpenComment != LexerChunk::NoComment)
+		InCommentState(std::exchange(m_OpenComment, LexerChunk::NoComment));
 	else
+		Next();
+	return true;
+}
+
+void Lexer::Next()
+{
+	if (m_Cursor == m_End)
 	{
+		if (m_CurrentSymbol == ESymbolCategories::End)
+			return;
+		m_CurrentCharacter = 0;
 		m_CurrentSymbol = ESymbolCategories::End;
-		Token lastToken = { 1, 1, +ETokenCode::Eof, " " };
-		if (!m_TokenSequence->empty())
-			lastToken  = m_TokenSequence->back();
-		m_TokenSequence->emplace_back(lastToken.Line, lastToken.Position, +ETokenCode::Eof, lastToken.Lexeme);
+		if (m_Chunk)
+		{
+			if (m_End == m_Source->End())
+				m_Chunk->EofIndex = m_TokenSequence->Size();
+			return;
+		}
+		// A seam of a chunked source, Refill() picks up from here
+		if (m_Source->HasMore())
+			return;
+		// Eof points at the last token, so errors at the end of the file are reported there
+		uint32_t last = m_TokenSequence->Size() - 1;
+		if (m_TokenSequence->Empty())
+			m_TokenSequence->Push(ETokenKind::Eof, +ETokenCode::Eof, 0, 0);
+		else
+			m_TokenSequence->Push(ETokenKind::Eof, +ETokenCode::Eof, m_TokenSequence->Offset(last), m_TokenSequence->Length(last));
+		return;
 	}
+
+	m_CurrentCharacter = *m_Cursor++;
+	unsigned char symbol = static_cast<unsigned char>(m_CurrentCharacter);
+	m_CurrentSymbol = symbol < m_Attributes.size() ? m_Attributes[symbol] : ESymbolCategories::None;
+}
+
+// Moves to 'to' as if Next() was called for every character in between
+void Lexer::SkipTo(const char* to)
+{
+	m_Cursor = to;
+	Next();
+}
+
+const char* Lexer::Current() const
+{
+	return m_CurrentSymbol == ESymbolCategories::End ? m_Cursor : m_Cursor - 1;
+}
+
+std::string_view Lexer::LexemeFrom(const char* lexemeStart) const
+{
+	return std::string_view(lexemeStart, Current() - lexemeStart);
+}
+
+void Lexer::PushToken(ETokenKind kind, uint32_t code, const char* lexemeStart)
+{
+	m_TokenSequence->Push(kind, code, OffsetOf(lexemeStart), static_cast<uint32_t>(Current() - lexemeStart));
+}
+
+// Can't wrap, SourceBuffer holds no more than SourceBuffer::MaxSize bytes
+uint32_t Lexer::OffsetOf(const char* p) const
+{
+	return m_Source->First() + static_cast<uint32_t>(p - m_Source->Begin());
+}
+
+// Every token starts where the lexer picks the next state, and from there on the result only depends on the text that follows.
+// So once both lexings start a token at the same place in the same text, everything after it is the same
+bool Lexer::AtResyncPoint()
+{
+	if (m_CurrentSymbol == ESymbolCategories::WhiteSpace)
+		return false;
+
+	int64_t offset = static_cast<int64_t>(OffsetOf(Current())) - m_Resync.Shift;
+	const TokenStream& tokens = *m_Resync.Tokens;
+	while (m_ResyncCursor < tokens.Size() && tokens.Offset(m_ResyncCursor) < offset)
+		m_ResyncCursor++;
+
+	if (m_ResyncCursor == tokens.Size() || tokens.Offset(m_ResyncCursor) != offset)
+		return false;
+	m_Chunk->ResyncIndex = m_ResyncCursor;
+	return true;
 }
 
 void Lexer::SetupSymbolCategories()
@@ -119,210 +387,173 @@ void Lexer::SetupSymbolCategories()
 	m_Attributes['.'] = ESymbolCategories::UnaryDelimiter;
 }
 
-void Lexer::SetupKeywordTable()
-{
-	KeyWordsTable["PROGRAM"]	= static_cast<uint32_t>(ETokenCode::KW_PROGRAM);
-	KeyWordsTable["VAR"]		= static_cast<uint32_t>(ETokenCode::KW_VAR);
-	KeyWordsTable["BEGIN"]	= static_cast<uint32_t>(ETokenCode::KW_BEGIN);
-	KeyWordsTable["END"]		= static_cast<uint32_t>(ETokenCode::KW_END);
-	KeyWordsTable["INTEGER"]	= static_cast<uint32_t>(ETokenCode::KW_INTEGER);
-	KeyWordsTable["FLOAT"]	= static_cast<uint32_t>(ETokenCode::KW_FLOAT);
-	KeyWordsTable["IF"]		= static_cast<uint32_t>(ETokenCode::KW_IF);
-	KeyWordsTable["THEN"]		= static_cast<uint32_t>(ETokenCode::KW_THEN);
-	KeyWordsTable["ELSE"]		= static_cast<uint32_t>(ETokenCode::KW_ELSE);
-	KeyWordsTable["ENDIF"]	= static_cast<uint32_t>(ETokenCode::KW_ENDIF);
-
-	KeyWordsTable[":="] = static_cast<uint32_t>(ETokenCode::DelimiterAssign);
-}
-
 void Lexer::WhiteSpaceState()
 {
-	while (m_CurrentSymbol == ESymbolCategories::WhiteSpace)
-	{
-		Next();
-	}
+	SkipTo(CharScanner::SkipWhiteSpace(m_Cursor, m_End));
 }
 
 void Lexer::IdentifierState()
 {
-	size_t lexemeLine = m_Line;
-	size_t lexemeStartPosition = m_Position;
-
-	while (m_CurrentSymbol == ESymbolCategories::Identifier ||
-		m_CurrentSymbol == ESymbolCategories::Constant)
-	{
-		m_TokenBuffer += m_CurrentCharacter;
-		Next();
-	}
+	const char* lexemeStart = Current();
 
-	uint32_t lexemeCode;
-
-	if (auto kwRecord = KeyWordsTable.find(m_TokenBuffer); kwRecord != KeyWordsTable.end())
-	{
-		lexemeCode = kwRecord->second;
-	}
-	else if (auto identifierRecord = IdentifiersTable.find(m_TokenBuffer); identifierRecord == IdentifiersTable.end())
-	{
-		lexemeCode = static_cast<uint32_t>(ETokenCode::IdentifierBase) + IdentifiersTable.size();
-		IdentifiersTable[m_TokenBuffer] = lexemeCode;
-	}
-	else
-	{
-		lexemeCode = identifierRecord->second;
-	}
-	
-	m_TokenSequence->emplace_back(lexemeLine, lexemeStartPosition, lexemeCode, m_TokenBuffer);
-	m_TokenBuffer.clear();
+	SkipTo(CharScanner::SkipIdentifier(m_Cursor, m_End));
+	PushIdentifier(lexemeStart);
 }
 
 void Lexer::ConstantState()
 {
-	size_t lexemeLine = m_Line;
-	size_t lexemeStartPosition = m_Position;
+	const char* lexemeStart = Current();
+	const char* suffixStart = nullptr;
 
-	while (m_CurrentSymbol == ESymbolCategories::Constant)
-	{
-		m_TokenBuffer += m_CurrentCharacter;
-		Next();
-	}
+	SkipTo(CharScanner::SkipDigits(m_Cursor, m_End));
 	if (m_CurrentSymbol != ESymbolCategories::WhiteSpace
 		&& m_CurrentSymbol != ESymbolCategories::MultiDelimiter
 		&& m_CurrentSymbol != ESymbolCategories::UnaryDelimiter
 		&& m_CurrentSymbol != ESymbolCategories::Comment)
 	{
-		std::string suffixBuffer;
+		suffixStart = Current();
 		while (m_CurrentSymbol != ESymbolCategories::WhiteSpace
 			&& m_CurrentSymbol != ESymbolCategories::MultiDelimiter
 			&& m_CurrentSymbol != ESymbolCategories::UnaryDelimiter
-			&& m_CurrentSymbol != ESymbolCategories::Comment)
+			&& m_CurrentSymbol != ESymbolCategories::Comment
+			&& m_CurrentSymbol != ESymbolCategories::End)
 		{
-			suffixBuffer += m_CurrentCharacter;
 			Next();
 		}
-		m_TokenBuffer += suffixBuffer;
-		auto error = ErrorHandler::CreateSyntaxError("Invalid suffix \"" + suffixBuffer + "\" on integer constant \"" + m_TokenBuffer + "\"", lexemeLine, lexemeStartPosition, m_Instigator);
-		m_ErrorHandler->ReportError(error);
 	}
+	PushConstant(lexemeStart, suffixStart);
+}
 
+// Identifier or keyword from 'lexemeStart' up to the current character
+void Lexer::PushIdentifier(const char* lexemeStart)
+{
+	std::string_view lexeme = LexemeFrom(lexemeStart);
+	ETokenKind lexemeKind;
 	uint32_t lexemeCode;
 
-	if (auto tableRecord = ConstantsTable.find(m_TokenBuffer); tableRecord == ConstantsTable.end())
+	if (ETokenCode keyword = Keywords::Find(lexeme); keyword != ETokenCode::None)
 	{
-		lexemeCode = static_cast<uint32_t>(ETokenCode::ConstantBase) + ConstantsTable.size(); 
-		ConstantsTable[m_TokenBuffer] = lexemeCode;
+		lexemeKind = ETokenKind::Keyword;
+		lexemeCode = +keyword;
 	}
 	else
 	{
-		lexemeCode = tableRecord->second;
+		lexemeKind = ETokenKind::Identifier;
+		lexemeCode = m_Context->Identifiers.Intern(lexeme);
 	}
+	
+	PushToken(lexemeKind, lexemeCode, lexemeStart);
+}
+
+// Constant from 'lexemeStart' up to the current character, 'suffixStart' is where its digits stopped if they were not followed by a delimiter
+void Lexer::PushConstant(const char* lexemeStart, const char* suffixStart)
+{
+	if (suffixStart)
+		ReportSyntaxError("Invalid suffix \"" + std::string(LexemeFrom(suffixStart)) + "\" on integer constant \"" + std::string(LexemeFrom(lexemeStart)) + "\"", lexemeStart);
+
+	const char* digitsEnd = suffixStart ? suffixStart : Current();
+	uint64_t value = 0;
+	if (!ParseDecimal(lexemeStart, digitsEnd, value) || value > s_MaxConstant)
+		ReportSyntaxError("Integer constant \"" + std::string(lexemeStart, digitsEnd) + "\" is too large for DWORD", lexemeStart);
 
-	m_TokenSequence->emplace_back(lexemeLine, lexemeStartPosition, lexemeCode, m_TokenBuffer);
-	m_TokenBuffer.clear();
+	uint32_t lexemeCode = m_Context->Constants.Intern(value);
+
+	PushToken(ETokenKind::Constant, lexemeCode, lexemeStart);
 }
 
 void Lexer::UnaryDelimiterState()
 {
-	size_t lexemeLine = m_Line;
-	size_t lexemeStartPosition = m_Position;
-
-	m_TokenBuffer += m_CurrentCharacter;
+	const char* lexemeStart = Current();
 
 	uint32_t lexemeCode = static_cast<uint32_t>(m_CurrentCharacter);
 	Next();
-	m_TokenSequence->emplace_back(lexemeLine, lexemeStartPosition, lexemeCode, m_TokenBuffer);
-	m_TokenBuffer.clear();
+	PushToken(ETokenKind::Delimiter, lexemeCode, lexemeStart);
 }
 
 void Lexer::MultiDelimiterState()
 {
-	size_t lexemeLine = m_Line;
-	size_t lexemeStartPosition = m_Position;
+	const char* lexemeStart = Current();
 
-	m_TokenBuffer += m_CurrentCharacter;
 	uint32_t lexemeCode = static_cast<uint32_t>(m_CurrentCharacter);
 	Next();
 	
 	if (m_CurrentCharacter == '=')
 	{
-		m_TokenBuffer += m_CurrentCharacter;
-		if (auto tableRecord = KeyWordsTable.find(m_TokenBuffer); tableRecord != KeyWordsTable.end())
+		Next();
+		if (ETokenCode keyword = Keywords::Find(LexemeFrom(lexemeStart)); keyword != ETokenCode::None)
 		{
-			lexemeCode = tableRecord->second;
+			lexemeCode = +keyword;
 		}
-		Next();
 	}
 
-	m_TokenSequence->emplace_back(lexemeLine, lexemeStartPosition, lexemeCode, m_TokenBuffer);
-	m_TokenBuffer.clear();
+	PushToken(ETokenKind::Delimiter, lexemeCode, lexemeStart);
 }
 
 void Lexer::CommentState()
 {
-	size_t comStartLine = m_Line;
-	size_t comStartPos = m_Position;
+	const char* commentStart = Current();
 	Next();
 	if (m_CurrentCharacter == '*')
 	{
-		InCommentState(comStartLine, comStartPos);
+		InCommentState(OffsetOf(commentStart));
 	}
 	else
 	{
-		auto error = ErrorHandler::CreateSyntaxError("Missing '*' after '(' in comment", comStartLine, comStartPos, m_Instigator);
-		m_ErrorHandler->ReportError(error);
+		ReportSyntaxError("Missing '*' after '(' in comment", commentStart);
 		Next();
 	}
 }
 
-void Lexer::InCommentState(size_t line, size_t pos)
+void Lexer::InCommentState(uint32_t commentStart)
 {
-	Next();
-	while (m_CurrentCharacter != '*' && m_CurrentCharacter != EOF)
+	const char* commentEnd = CharScanner::FindCommentEnd(m_Cursor, m_End);
+	if (commentEnd == m_End)
 	{
-		Next();
+		SkipTo(m_End);
+		ReportOpenComment(commentStart);
+		return;
 	}
 
-	if (m_CurrentCharacter == '*')
-	{
-		EndCommentState(line, pos);
-	}
-	else
-	{
-		auto error = ErrorHandler::CreateSyntaxError("Comment not closed", line, pos, m_Instigator);
-		m_ErrorHandler->ReportError(error);
-	}
+	SkipTo(commentEnd + 1);
 }
 
-void Lexer::EndCommentState(size_t line, size_t pos)
+// 'commentStart' is NoComment for a comment opened in an earlier chunk
+void Lexer::ReportOpenComment(uint32_t commentStart)
 {
-	while (m_CurrentCharacter == '*')
+	// The next chunk decides whether it gets closed
+	if (m_Chunk)
 	{
-		Next();
+		m_Chunk->bEndsInComment = true;
+		m_Chunk->OpenComment = commentStart;
+		return;
 	}
-
-	if (m_CurrentCharacter == ')')
+	if (m_Source->HasMore())
 	{
-		Next();
+		m_OpenComment = commentStart;
 		return;
 	}
+	ReportSyntaxError("Comment not closed", commentStart);
+}
 
-	InCommentState(line, pos);
+void Lexer::ReportSyntaxError(const std::string& errorMessage, const char* at)
+{
+	ReportSyntaxError(errorMessage, OffsetOf(at));
 }
 
-void Lexer::ReverseTables()
+void Lexer::ReportSyntaxError(const std::string& errorMessage, uint32_t offset)
 {
-	for (const auto& pair : KeyWordsTable) {
-		Reverse_KeyWordsTable[pair.second] = pair.first;
-	}
-	for (const auto& pair : ConstantsTable) {
-		Reverse_ConstantsTable[pair.second] = pair.first;
-	}
-	for (const auto& pair : IdentifiersTable) {
-		Reverse_IdentifiersTable[pair.second] = pair.first;
+	if (m_Chunk)
+	{
+		m_Chunk->Errors.emplace_back(offset, errorMessage);
+		return;
 	}
+	auto error = CreateSyntaxError(errorMessage, offset);
+	m_ErrorHandler->ReportError(error);
 }
 
-Error Lexer::CreateSyntaxError(const std::string& errorMessage, uint32_t line, uint32_t pos)
+Error Lexer::CreateSyntaxError(const std::string& errorMessage, uint32_t offset)
 {
-	return ErrorHandler::CreateSyntaxError(errorMessage, line, pos, m_Instigator);
+	SourceLocation location = m_TokenSequence->Locate(offset);
+	return ErrorHandler::CreateSyntaxError(errorMessage, location.Line, location.Position, m_Instigator);
 }
 
@@ -1,13 +1,15 @@
 #pragma once
 
 #include "Data/Token.h"
+#include "Data/TokenStream.h"
+#include "Data/SourceBuffer.h"
+#include "Data/CompilationContext.h"
 #include "Errors/Error.h"
 
 #include <cstdint>
-#include <fstream>
 #include <array>
 #include <vector>
-#include <unordered_map>
+#include <string>
 #include <memory>
 
 
@@ -24,30 +26,76 @@ enum class ESymbolCategories : uint8_t
 
 };
 
-struct LexerData
+// Both engines produce the same tokens and errors
+enum class ELexerEngine : uint8_t
 {
-	std::shared_ptr<std::vector<Token>> Tokens;
-	std::unordered_map<std::string, uint32_t> ConstantsTable;
-	std::unordered_map<std::string, uint32_t> IdentifiersTable;
-	std::unordered_map<std::string, uint32_t> KeyWordsTable;
+	StateMachine = 0,	// A method per state, runs of characters are skipped with CharScanner
+	Table				// Compile-time transition table, see LexerTable.h
+};
+
+// Result of lexing one chunk of a source on its own, see ParallelLexer
+struct LexerChunk
+{
+	static constexpr uint32_t NoComment = UINT32_MAX;
+	static constexpr uint32_t NoEof = UINT32_MAX;
+	static constexpr uint32_t NoResync = UINT32_MAX;
+
+	std::shared_ptr<CompilationContext> Context;	// Tokens and symbol tables of this chunk alone
+	std::vector<std::pair<uint32_t, std::string>> Errors;	// Source offset and message
+
+	bool bEndsInComment = false;
+	uint32_t OpenComment = NoComment;	// Start of the comment left open, if it was opened in this chunk
+	uint32_t EofIndex = NoEof;			// Where the sequential lexer would have pushed Eof, for the chunk that ends the source
+	uint32_t ResyncIndex = NoResync;	// Token of the other variant this one stopped at, the rest is shared with it
+
+	// Interns the symbols of the tokens from 'first' on in 'context' and rewrites their codes to its ids.
+	// Symbols are interned on first use, so ids still follow the order of first appearance
+	void MoveSymbolsTo(CompilationContext& context, uint32_t first);
+};
+
+// Earlier lexing of the same text for ScanChunk to line up with
+struct ResyncTarget
+{
+	const TokenStream* Tokens = nullptr;
+	uint32_t First = 0;		// Tokens before it are not lined up with
+	int64_t Shift = 0;		// Added to their offsets, for text that moved since it was lexed
 };
 
 class ErrorHandler;
 
-class Lexer 
+class Lexer : public TokenSource
 {
 public:
-	Lexer(std::shared_ptr<std::vector<Token>>& tokenSequence, std::shared_ptr<ErrorHandler> errorHandler);
+	Lexer(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler);
+
+	// Large sources are lexed in parallel when 'threadCount' is above 1
+	void Scan(const std::string& filePath, uint32_t threadCount = 1);
+
+	// Scan() in steps: Open, then ScanNext until it returns false
+	bool Open(const std::string& filePath);
+	virtual bool ScanNext(uint32_t count) override;
 
-	void Scan(const std::string& filePath);
+	void SetEngine(ELexerEngine engine);
 
-	std::shared_ptr<LexerData> GetLexerData();
+	// Lexes [begin, end) of 'source' into the lexer's context, without an Eof token.
+	// 'end' must follow a whitespace character or be the end of the source.
+	// With a 'resync' target lexing stops at the first token that also starts one of its tokens
+	void ScanChunk(std::shared_ptr<SourceBuffer> source, uint32_t begin, uint32_t end, bool bInComment, LexerChunk& chunk,
+		const ResyncTarget& resync = {});
 
 private:
 	void Next();
+	void SkipTo(const char* to);
+	const char* Current() const;
+	std::string_view LexemeFrom(const char* lexemeStart) const;
+	void PushToken(ETokenKind kind, uint32_t code, const char* lexemeStart);
+	uint32_t OffsetOf(const char* p) const;
+	bool AtResyncPoint();
+	const char* FindSeam() const;
+	bool Refill();
+	bool ScanNextTable(uint32_t count);
 
 	void SetupSymbolCategories();
-	void SetupKeywordTable();
 
 	void WhiteSpaceState();
 	void IdentifierState();
@@ -55,28 +103,37 @@ private:
 	void UnaryDelimiterState();
 	void MultiDelimiterState();
 
+	void PushIdentifier(const char* lexemeStart);
+	void PushConstant(const char* lexemeStart, const char* suffixStart);
+
 	void CommentState();
-	void InCommentState(size_t line, size_t pos);
-	void EndCommentState(size_t line, size_t pos);
+	void InCommentState(uint32_t commentStart);
+	void ReportOpenComment(uint32_t commentStart);
+	void ReportSyntaxError(const std::string& errorMessage, const char* at);
+	void ReportSyntaxError(const std::string& errorMessage, uint32_t offset);
 
-	void ReverseTables();
 
 private:
-	Error CreateSyntaxError(const std::string& errorMessage, uint32_t line, uint32_t pos);
+	Error CreateSyntaxError(const std::string& errorMessage, uint32_t offset);
 
 private:
-	std::ifstream m_InputFile;
-	
+	std::shared_ptr<SourceBuffer> m_Source;
+	const char* m_Cursor;
+	const char* m_End;
+
 	// Lexer state
-	size_t m_Line;
-	size_t m_Position;
+	ELexerEngine m_Engine;
 	char m_CurrentCharacter;
 	ESymbolCategories m_CurrentSymbol;
 	std::array<ESymbolCategories, 128> m_Attributes;
 	
 	// Token-related
-	std::string m_TokenBuffer;
-	std::shared_ptr<std::vector<Token>> m_TokenSequence;
+	std::shared_ptr<CompilationContext> m_Context;
+	std::shared_ptr<TokenStream> m_TokenSequence;
+	LexerChunk* m_Chunk;
+	ResyncTarget m_Resync;
+	uint32_t m_ResyncCursor;
+	uint32_t m_OpenComment;		// Start of a comment left open at a seam of a chunked source
 
 
 	std::shared_ptr<ErrorHandler> m_ErrorHandler;
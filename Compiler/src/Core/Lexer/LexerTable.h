@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Transition table of the table-driven lexer engine, built at compile time.
+// A token is lexed by stepping through the table one byte at a time until it lands in an accept state,
+// only then the lexer looks at what was found. Must stay in sync with Lexer::SetupSymbolCategories
+namespace LexerTable
+{
+	enum EByteClass : uint8_t
+	{
+		WhiteSpace = 0,
+		Letter,
+		Digit,
+		Colon,
+		Equals,
+		Delimiter,		// ';' and '.', '=' has its own class for ":="
+		OpenParen,
+		Star,
+		CloseParen,
+		Other,
+		End,			// Not a byte, looked up once the source runs out
+		ByteClassCount
+	};
+
+	enum EState : uint8_t
+	{
+		Start = 0,
+		InWhiteSpace,
+		InIdentifier,
+		InConstant,
+		InSuffix,
+		InColon,
+		InOpenParen,
+		InComment,
+		InCommentStar,
+		RunningStateCount,
+
+		// Accept states, the token ends before the byte that led here
+		AcceptWhiteSpace = RunningStateCount,
+		AcceptIdentifier,
+		AcceptConstant,
+		AcceptSuffixedConstant,
+		AcceptColon,
+		AcceptOpenComment,
+
+		// Accept states, the token ends with the byte that led here
+		AcceptDelimiter,
+		AcceptAssign,
+		AcceptComment,
+		AcceptMissingStar,
+		AcceptIllegal,
+		StateCount
+	};
+
+	inline constexpr uint8_t FirstAccept = RunningStateCount;
+	inline constexpr uint8_t FirstInclusiveAccept = AcceptDelimiter;
+
+	using ClassTable = std::array<uint8_t, 256>;
+	using TransitionTable = std::array<std::array<uint8_t, ByteClassCount>, RunningStateCount>;
+
+	constexpr ClassTable BuildClasses()
+	{
+		ClassTable classes{};
+		for (size_t c = 0; c < classes.size(); c++)
+		{
+			if ((c >= 8 && c <= 13) || c == ' ')
+				classes[c] = WhiteSpace;
+			else if ((c >= '@' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_')
+				classes[c] = Letter;
+			else if (c >= '0' && c <= '9')
+				classes[c] = Digit;
+			else
+				classes[c] = Other;
+		}
+		classes[':'] = Colon;
+		classes['='] = Equals;
+		classes[';'] = Delimiter;
+		classes['.'] = Delimiter;
+		classes['('] = OpenParen;
+		classes['*'] = Star;
+		classes[')'] = CloseParen;
+		return classes;
+	}
+
+	constexpr void Fill(std::array<uint8_t, ByteClassCount>& row, uint8_t state)
+	{
+		for (uint8_t& next : row)
+			next = state;
+	}
+
+	// Classes a constant may be directly followed by without an "Invalid suffix" error
+	constexpr bool EndsConstant(uint8_t byteClass)
+	{
+		return byteClass == WhiteSpace || byteClass == Colon || byteClass == Equals || byteClass == Delimiter || byteClass == OpenParen;
+	}
+
+	constexpr TransitionTable BuildTransitions()
+	{
+		TransitionTable table{};
+
+		auto& start = table[Start];
+		Fill(start, AcceptIllegal);
+		start[WhiteSpace] = InWhiteSpace;
+		start[Letter] = InIdentifier;
+		start[Digit] = InConstant;
+		start[Colon] = InColon;
+		start[Equals] = AcceptDelimiter;
+		start[Delimiter] = AcceptDelimiter;
+		start[OpenParen] = InOpenParen;
+
+		Fill(table[InWhiteSpace], AcceptWhiteSpace);
+		table[InWhiteSpace][WhiteSpace] = InWhiteSpace;
+
+		Fill(table[InIdentifier], AcceptIdentifier);
+		table[InIdentifier][Letter] = InIdentifier;
+		table[InIdentifier][Digit] = InIdentifier;
+
+		// Running out of source right after the digits is reported as an empty suffix, like the state machine does
+		for (uint8_t byteClass = 0; byteClass < ByteClassCount; byteClass++)
+		{
+			table[InConstant][byteClass] = EndsConstant(byteClass) ? AcceptConstant : InSuffix;
+			table[InSuffix][byteClass] = EndsConstant(byteClass) || byteClass == End ? AcceptSuffixedConstant : InSuffix;
+		}
+		table[InConstant][Digit] = InConstant;
+		table[InConstant][End] = AcceptSuffixedConstant;
+
+		Fill(table[InColon], AcceptColon);
+		table[InColon][Equals] = AcceptAssign;
+
+		// Whatever follows a lone '(' is swallowed with it
+		Fill(table[InOpenParen], AcceptMissingStar);
+		table[InOpenParen][Star] = InComment;
+
+		Fill(table[InComment], InComment);
+		table[InComment][Star] = InCommentStar;
+		table[InComment][End] = AcceptOpenComment;
+
+		Fill(table[InCommentStar], InComment);
+		table[InCommentStar][Star] = InCommentStar;
+		table[InCommentStar][CloseParen] = AcceptComment;
+		table[InCommentStar][End] = AcceptOpenComment;
+
+		return table;
+	}
+
+	inline constexpr ClassTable Classes = BuildClasses();
+	inline constexpr TransitionTable Transitions = BuildTransitions();
+
+	constexpr bool AcceptsAtEnd()
+	{
+		for (const auto& row : Transitions)
+		{
+			if (row[End] < FirstAccept)
+				return false;
+		}
+		return true;
+	}
+	static_assert(AcceptsAtEnd(), "Every state has to accept once the source runs out");
+}
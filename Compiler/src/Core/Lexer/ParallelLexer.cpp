@@ -0,0 +1,149 @@
+#include "ParallelLexer.h"
+#include "Lexer.h"
+#include "CharScanner.h"
+#include "Errors/ErrorHandler.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <future>
+
+static constexpr size_t s_ChunksPerThread = 4;
+
+ParallelLexer::ParallelLexer(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler, ELexerEngine engine)
+	: m_Context(context), m_TokenSequence(context->Tokens), m_ErrorHandler(errorHandler), m_Engine(engine)
+{
+}
+
+void ParallelLexer::Scan(std::shared_ptr<SourceBuffer> source, uint32_t threadCount)
+{
+	size_t chunkCount = std::clamp<size_t>(source->Size() / MinChunkSize, 1, threadCount * s_ChunksPerThread);
+	std::vector<uint32_t> bounds = SplitIntoChunks(*source, chunkCount);
+	chunkCount = bounds.size() - 1;
+
+	std::vector<LexerChunk> outside(chunkCount);
+	std::vector<LexerChunk> inside(chunkCount);
+	{
+		ThreadPool pool(threadCount);
+		std::vector<std::shared_future<void>> outsideDone;
+		for (size_t i = 0; i < chunkCount; i++)
+			outsideDone.push_back(pool.Submit([&, i]() { LexChunk(source, bounds[i], bounds[i + 1], false, outside[i], nullptr); }).share());
+
+		// Queued after every outside task, so waiting on one here never waits on a task that has not started
+		std::vector<std::future<void>> insideDone;
+		for (size_t i = 1; i < chunkCount; i++)
+		{
+			insideDone.push_back(pool.Submit([&, i, ready = outsideDone[i]]()
+			{
+				ready.wait();
+				LexChunk(source, bounds[i], bounds[i + 1], true, inside[i], outside[i].Context->Tokens.get());
+			}));
+		}
+
+		for (std::shared_future<void>& task : outsideDone)
+			task.get();
+		for (std::future<void>& task : insideDone)
+			task.get();
+	}
+
+	bool bInComment = false;
+	uint32_t openComment = LexerChunk::NoComment;
+	for (size_t i = 0; i < chunkCount; i++)
+	{
+		LexerChunk* chunk = &outside[i];
+		if (bInComment)
+		{
+			chunk = &inside[i];
+			Append(*chunk, 0, 0);
+			if (uint32_t resync = chunk->ResyncIndex; resync != LexerChunk::NoResync)
+			{
+				chunk = &outside[i];
+				Append(*chunk, resync, chunk->Context->Tokens->Offset(resync));
+			}
+		}
+		else
+		{
+			Append(*chunk, 0, 0);
+		}
+
+		if (chunk->bEndsInComment && chunk->OpenComment != LexerChunk::NoComment)
+			openComment = chunk->OpenComment;
+		bInComment = chunk->bEndsInComment;
+
+		outside[i] = LexerChunk();
+		inside[i] = LexerChunk();
+	}
+	if (bInComment)
+		ReportSyntaxError("Comment not closed", openComment);
+}
+
+// Returns chunk starts followed by the source size. Every chunk but the last ends right after a whitespace character.
+// The splits are found as size_t, a source holds at most SourceBuffer::MaxSize bytes so they fit the 32-bit bounds
+std::vector<uint32_t> ParallelLexer::SplitIntoChunks(const SourceBuffer& source, size_t chunkCount) const
+{
+	static_assert(SourceBuffer::MaxSize <= UINT32_MAX, "Chunk bounds are token offsets");
+	const char* data = source.Begin();
+	size_t size = source.Size();
+	size_t step = size / chunkCount;
+
+	std::vector<uint32_t> bounds = { 0 };
+	for (size_t i = 1; i < chunkCount; i++)
+	{
+		size_t split = std::max<size_t>(i * step, bounds.back());
+		while (split < size && !CharScanner::IsWhiteSpace(data[split]))
+			split++;
+		if (split + 1 >= size)
+			break;
+		bounds.push_back(static_cast<uint32_t>(split + 1));
+	}
+	bounds.push_back(static_cast<uint32_t>(size));
+	return bounds;
+}
+
+void ParallelLexer::LexChunk(std::shared_ptr<SourceBuffer> source, uint32_t begin, uint32_t end, bool bInComment, LexerChunk& chunk,
+	const TokenStream* resyncWith)
+{
+	chunk.Context = std::make_shared<CompilationContext>();
+	Lexer lexer(chunk.Context, m_ErrorHandler);
+	lexer.SetEngine(m_Engine);
+	lexer.ScanChunk(source, begin, end, bInComment, chunk, { resyncWith, 0, 0 });
+}
+
+// Moves the chunk's tokens from 'first' on over, re-interning their symbols in the shared tables,
+// and reports its errors from 'fromOffset' on
+void ParallelLexer::Append(LexerChunk& chunk, uint32_t first, uint32_t fromOffset)
+{
+	chunk.MoveSymbolsTo(*m_Context, first);
+
+	const TokenStream& tokens = *chunk.Context->Tokens;
+	for (uint32_t i = first; i < tokens.Size(); i++)
+	{
+		if (i == chunk.EofIndex)
+			PushEof();
+		m_TokenSequence->Push(tokens.Kind(i), tokens.Code(i), tokens.Offset(i), tokens.Length(i));
+	}
+	if (chunk.EofIndex == tokens.Size())
+		PushEof();
+
+	for (const auto& [offset, message] : chunk.Errors)
+	{
+		if (offset >= fromOffset)
+			ReportSyntaxError(message, offset);
+	}
+}
+
+// Same Eof the sequential lexer pushes: at the last token, before any token finished by reaching the end of the source
+void ParallelLexer::PushEof()
+{
+	uint32_t last = m_TokenSequence->Size() - 1;
+	if (m_TokenSequence->Empty())
+		m_TokenSequence->Push(ETokenKind::Eof, +ETokenCode::Eof, 0, 0);
+	else
+		m_TokenSequence->Push(ETokenKind::Eof, +ETokenCode::Eof, m_TokenSequence->Offset(last), m_TokenSequence->Length(last));
+}
+
+void ParallelLexer::ReportSyntaxError(const std::string& errorMessage, uint32_t offset)
+{
+	SourceLocation location = m_TokenSequence->Locate(offset);
+	auto error = ErrorHandler::CreateSyntaxError(errorMessage, location.Line, location.Position, EErrorInstigator::Lexer);
+	m_ErrorHandler->ReportError(error);
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Data/TokenStream.h"
+#include "Data/SourceBuffer.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct LexerChunk;
+struct CompilationContext;
+enum class ELexerEngine : uint8_t;
+class ErrorHandler;
+
+// Lexes a large source in chunks on a thread pool and stitches the results into one TokenStream.
+// Chunks end right after a whitespace character, so the only thing that can cross a seam is a comment.
+// Every chunk but the first is lexed twice, as if its start was outside and inside a comment,
+// and stitching keeps whichever variant matches the way the previous chunk ended.
+// The inside variant stops as soon as it lines up with the outside one, so the second pass is usually short.
+class ParallelLexer
+{
+public:
+	static constexpr size_t MinSourceSize = 4 << 20;
+	static constexpr size_t MinChunkSize = 1 << 20;
+
+	ParallelLexer(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler, ELexerEngine engine);
+
+	void Scan(std::shared_ptr<SourceBuffer> source, uint32_t threadCount);
+
+private:
+	std::vector<uint32_t> SplitIntoChunks(const SourceBuffer& source, size_t chunkCount) const;
+	void LexChunk(std::shared_ptr<SourceBuffer> source, uint32_t begin, uint32_t end, bool bInComment, LexerChunk& chunk,
+		const TokenStream* resyncWith);
+	void Append(LexerChunk& chunk, uint32_t first, uint32_t fromOffset);
+	void PushEof();
+	void ReportSyntaxError(const std::string& errorMessage, uint32_t offset);
+
+private:
+	std::shared_ptr<CompilationContext> m_Context;
+	std::shared_ptr<TokenStream> m_TokenSequence;
+	std::shared_ptr<ErrorHandler> m_ErrorHandler;
+	ELexerEngine m_Engine;
+};
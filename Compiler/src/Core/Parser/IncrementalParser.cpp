@@ -0,0 +1,427 @@
+#include "IncrementalParser.h"
+#include "Data/Nodes.h"
+#include "Errors/ErrorHandler.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Items [First, Last) of a list that the damage falls in, they held tokens [Begin, End) before it
+	struct ItemRange
+	{
+		uint32_t First;
+		uint32_t Last;
+		uint32_t Begin;
+		uint32_t End;
+	};
+
+	struct IfParts
+	{
+		IfParts(Ref<ASTNode> stmt)
+		{
+			auto condition = static_cast<NConditionStmt*>(static_cast<NIfStmt*>(stmt)->CondStmt);
+			Then = static_cast<NIncompleteConditionStmt*>(condition->IncompleteCondStmt);
+			Else = static_cast<NAlternativePart*>(condition->AltPart);
+			Condition = static_cast<NConditionalExpr*>(Then->CondExpr);
+		}
+
+		Ref<NConditionalExpr> Condition;
+		Ref<NIncompleteConditionStmt> Then;
+		Ref<NAlternativePart> Else;
+	};
+
+	// A statement that doesn't start like one is skipped without an error when the list ends right after it,
+	// and a list that has nothing but such a statement is left out altogether
+	bool AllListsComplete(Ref<ASTNode> root)
+	{
+		std::vector<Ref<ASTNode>> pending = { root };
+		while (!pending.empty())
+		{
+			Ref<ASTNode> node = pending.back();
+			pending.pop_back();
+			if (Ref<NStmtsList> list = dynamic_cast<NStmtsList*>(node); list && !list->Complete)
+				return false;
+			if (Ref<NBlock> block = dynamic_cast<NBlock*>(node); block && (!block->VarDecl || !block->StmtsList))
+				return false;
+			if (Ref<NVariableDeclarations> variables = dynamic_cast<NVariableDeclarations*>(node); variables && !variables->Empty && !variables->DeclList)
+				return false;
+			if (Ref<NIncompleteConditionStmt> then = dynamic_cast<NIncompleteConditionStmt*>(node); then && !then->StmtsList)
+				return false;
+			if (Ref<NAlternativePart> alternative = dynamic_cast<NAlternativePart*>(node); alternative && !alternative->Empty && !alternative->StmtsList)
+				return false;
+			if (node)
+				AST::ForEachChild(*node, [&pending](Ref<ASTNode> child) { pending.push_back(child); });
+		}
+		return true;
+	}
+
+	bool Inside(const TokenDamage& damage, uint32_t begin, uint32_t end)
+	{
+		return begin <= damage.First && damage.OldEnd <= end;
+	}
+
+	// Token of a variable or a constant
+	uint32_t LeafToken(Ref<ASTNode> expr)
+	{
+		if (Ref<NVariableIdentifier> variable = dynamic_cast<NVariableIdentifier*>(expr); variable)
+			return static_cast<NIdentifier*>(variable->Identifier)->TokenIndex;
+		return static_cast<NConstant*>(expr)->TokenIndex;
+	}
+
+	NodeList* ItemsOf(Ref<ASTNode> node)
+	{
+		if (Ref<NStmtsList> stmts = dynamic_cast<NStmtsList*>(node); stmts)
+			return &stmts->Stmts;
+		if (Ref<NDeclarationsList> decls = dynamic_cast<NDeclarationsList*>(node); decls)
+			return &decls->Decls;
+		return nullptr;
+	}
+
+	// Items tile the list, so they are found by where they start. Damage that only inserts tokens between two items has none
+	template<typename StartOf>
+	ItemRange FindDamagedItems(uint32_t count, const TokenDamage& damage, StartOf startOf)
+	{
+		auto firstWhere = [count](auto predicate)
+		{
+			uint32_t low = 0;
+			uint32_t high = count;
+			while (low < high)
+			{
+				uint32_t middle = low + (high - low) / 2;
+				if (predicate(middle))
+					high = middle;
+				else
+					low = middle + 1;
+			}
+			return low;
+		};
+
+		ItemRange range;
+		range.First = firstWhere([&](uint32_t i) { return startOf(i + 1) > damage.First; });
+		range.Last = firstWhere([&](uint32_t i) { return startOf(i) >= damage.OldEnd; });
+		range.Begin = range.First < range.Last ? std::min(startOf(range.First), damage.First) : damage.First;
+		range.End = range.First < range.Last ? std::max(startOf(range.Last), damage.OldEnd) : damage.OldEnd;
+		return range;
+	}
+}
+
+IncrementalParser::IncrementalParser(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler)
+	: m_Context(context), m_ErrorHandler(errorHandler), m_Parser(context, errorHandler),
+	m_RangeErrors(std::make_shared<ErrorHandler>()), m_RangeParser(context, m_RangeErrors)
+{
+}
+
+void IncrementalParser::Parse()
+{
+	size_t reported = m_ErrorHandler->GetErrors()->size();
+	m_Lists.clear();
+	m_Parser.Parse();
+	m_bClean = m_ErrorHandler->GetErrors()->size() == reported && AllListsComplete(m_Context->AST);
+	m_ParsedBytes = m_Context->Nodes.BytesUsed();
+	m_LastReparsed = m_Context->Tokens->Size();
+}
+
+// Replaced items stay in the arena, once they could have made up the whole tree again it is parsed in full instead.
+// Errors hold the line and column they were reported at, a tree with errors is parsed again after an edit that only
+// moved tokens too, so they are reported where the tokens are now
+void IncrementalParser::Reparse(const TokenDamage& damage)
+{
+	m_LastReparsed = 0;
+	if (damage.Empty() && m_bClean)
+		return;
+
+	if (!m_bClean || m_Context->Nodes.BytesUsed() > 2 * m_ParsedBytes || !TryReparse(damage))
+		Parse();
+}
+
+// Walks the whole tree, once for any number of edits
+void IncrementalParser::SettleLeaves()
+{
+	if (std::none_of(m_Lists.begin(), m_Lists.end(), [](const auto& list) { return list.second.ShiftDelta != 0; }))
+		return;
+
+	std::vector<std::pair<Ref<ASTNode>, int64_t>> pending = { { m_Context->AST, 0 } };
+	while (!pending.empty())
+	{
+		auto [node, lag] = pending.back();
+		pending.pop_back();
+		if (!node)
+			continue;
+
+		if (Ref<NIdentifier> identifier = dynamic_cast<NIdentifier*>(node); identifier)
+		{
+			identifier->TokenIndex = static_cast<uint32_t>(identifier->TokenIndex + lag);
+			continue;
+		}
+		if (Ref<NConstant> constant = dynamic_cast<NConstant*>(node); constant)
+		{
+			constant->TokenIndex = static_cast<uint32_t>(constant->TokenIndex + lag);
+			continue;
+		}
+
+		NodeList* items = ItemsOf(node);
+		auto state = items ? m_Lists.find(items) : m_Lists.end();
+		for (uint32_t i = 0, count = node->ChildCount(); i < count; i++)
+		{
+			bool bShifted = state != m_Lists.end() && i >= state->second.ShiftFrom;
+			pending.push_back({ node->Child(i), bShifted ? lag + state->second.ShiftDelta : lag });
+		}
+	}
+
+	for (auto& [items, state] : m_Lists)
+		state.ShiftDelta = 0;
+}
+
+// PROGRAM <name> ; [VAR <declarations>] BEGIN <statements> END .
+bool IncrementalParser::TryReparse(const TokenDamage& damage)
+{
+	m_Tails.clear();
+	m_RangeErrors->GetErrors()->clear();
+
+	auto program = static_cast<NProgram*>(static_cast<NSignalProgram*>(m_Context->AST)->Program);
+	if (!program)
+		return false;
+	auto block = static_cast<NBlock*>(program->Block);
+	auto variables = static_cast<NVariableDeclarations*>(block->VarDecl);
+	auto stmts = static_cast<NStmtsList*>(block->StmtsList);
+	uint32_t name = static_cast<NIdentifier*>(static_cast<NProcedureIdentifier*>(program->ProcIdentifier)->Identifier)->TokenIndex;
+
+	uint32_t begin = name + 2;
+	if (!variables->Empty)
+	{
+		// A declaration is always <name> : <type> ;
+		auto decls = static_cast<NDeclarationsList*>(variables->DeclList);
+		uint32_t declsBegin = name + 3;
+		begin = declsBegin + 4 * decls->Decls.Size();
+		if (Inside(damage, declsBegin, begin))
+		{
+			m_Tails.push_back({ &stmts->Stmts, 0 });
+			return ReparseDeclarations(damage, decls, begin);
+		}
+	}
+
+	uint32_t stmtsBegin = begin + 1;
+	uint32_t stmtsEnd = stmts->Stmts.Empty() ? stmtsBegin : StatementEnd(stmts->Stmts, stmts->Stmts.Size() - 1, 0);
+	if (!Inside(damage, stmtsBegin, stmtsEnd))
+		return false;
+	return ReparseStatements(damage, stmts, stmtsEnd);
+}
+
+// Goes down into the THEN or ELSE part of an IF while all of the damage is in there
+bool IncrementalParser::ReparseStatements(const TokenDamage& damage, Ref<NStmtsList> list, uint32_t listEnd)
+{
+	// What the items of the list lag behind, from the shifts of the items it is nested in
+	int64_t lag = 0;
+	for (;;)
+	{
+		NodeList& items = list->Stmts;
+		auto startOf = [&](uint32_t i) { return i < items.Size() ? StatementStart(items, i, lag) : listEnd; };
+		ItemRange range = FindDamagedItems(items.Size(), damage, startOf);
+
+		if (range.Last - range.First == 1 && dynamic_cast<NIfStmt*>(items[range.First]))
+		{
+			int64_t ifLag = lag + Lag(items, range.First);
+			IfParts parts(items[range.First]);
+			uint32_t endif = startOf(range.Last) - 2;
+			uint32_t thenBegin = static_cast<uint32_t>(LeafToken(parts.Condition->Expr2) + ifLag + 2);
+			uint32_t thenEnd = endif;
+			uint32_t elseBegin = endif;
+			Ref<NStmtsList> elseList = nullptr;
+			if (!parts.Else->Empty)
+			{
+				elseList = static_cast<NStmtsList*>(parts.Else->StmtsList);
+				if (!elseList->Stmts.Empty())
+					elseBegin = StatementStart(elseList->Stmts, 0, ifLag);
+				thenEnd = elseBegin - 1;
+			}
+
+			Ref<NStmtsList> inner = nullptr;
+			if (Inside(damage, thenBegin, thenEnd))
+			{
+				inner = static_cast<NStmtsList*>(parts.Then->StmtsList);
+				listEnd = thenEnd;
+				if (elseList)
+					m_Tails.push_back({ &elseList->Stmts, 0 });
+			}
+			else if (elseList && Inside(damage, elseBegin, endif))
+			{
+				inner = elseList;
+				listEnd = endif;
+			}
+
+			if (inner)
+			{
+				m_Tails.push_back({ &items, range.Last });
+				list = inner;
+				lag = ifLag;
+				continue;
+			}
+		}
+
+		uint32_t end = static_cast<uint32_t>(range.End + damage.Shift());
+		auto reparsed = static_cast<NStmtsList*>(m_RangeParser.ParseStatementsRange(range.Begin, end));
+		if (!reparsed || !reparsed->Complete || !m_RangeErrors->GetErrors()->empty())
+			return false;
+
+		Graft(items, range.First, range.Last, reparsed->Stmts, lag, damage.Shift());
+		m_LastReparsed = end - range.Begin;
+		return true;
+	}
+}
+
+bool IncrementalParser::ReparseDeclarations(const TokenDamage& damage, Ref<NDeclarationsList> list, uint32_t listEnd)
+{
+	NodeList& items = list->Decls;
+	auto startOf = [&](uint32_t i) { return i < items.Size() ? static_cast<uint32_t>(LeafToken(static_cast<NDeclaration*>(items[i])->VarIdentifier) + Lag(items, i)) : listEnd; };
+	ItemRange range = FindDamagedItems(items.Size(), damage, startOf);
+
+	uint32_t end = static_cast<uint32_t>(range.End + damage.Shift());
+	auto reparsed = static_cast<NDeclarationsList*>(m_RangeParser.ParseDeclarationsRange(range.Begin, end));
+	if (!reparsed || !m_RangeErrors->GetErrors()->empty())
+		return false;
+
+	Graft(items, range.First, range.Last, reparsed->Decls, 0, damage.Shift());
+	m_LastReparsed = end - range.Begin;
+	return true;
+}
+
+// Puts 'with' in place of items [first, last) of a list whose items lag behind by 'lag'.
+// The list keeps its node, and its array too unless the count outgrows it
+void IncrementalParser::Graft(NodeList& items, uint32_t first, uint32_t last, const NodeList& with, int64_t lag, int64_t shift)
+{
+	ListState& state = m_Lists[&items];
+	uint32_t count = items.Size() - (last - first) + with.Size();
+
+	// New leaves are up to date. The items they take the place of can have any shift, those after them take in 'shift'
+	if (shift == 0 && state.ShiftFrom <= first)
+	{
+		lag += state.ShiftDelta;
+	}
+	else
+	{
+		if (state.ShiftFrom < first)
+			MoveShift(items, state, first);
+		else if (state.ShiftFrom > last)
+			MoveShift(items, state, last);
+		state.ShiftFrom = first + with.Size();
+		state.ShiftDelta += shift;
+	}
+	for (Ref<ASTNode> item : with)
+		ShiftLeaves(item, -lag);
+
+	if (count > state.Capacity && count != items.Size())
+	{
+		// Room for the list to grow, so edits that add items don't copy it every time
+		state.Capacity = count + count / 2;
+		m_Items.assign(items.begin(), items.begin() + first);
+		m_Items.resize(first + with.Size());
+		m_Items.insert(m_Items.end(), items.begin() + last, items.end());
+		m_Items.resize(state.Capacity, nullptr);
+		items.Items = m_Context->Nodes.Copy(m_Items.data(), m_Items.size());
+	}
+	else if (with.Size() > last - first)
+	{
+		std::copy_backward(items.begin() + last, items.end(), items.begin() + count);
+	}
+	else if (with.Size() < last - first)
+	{
+		std::copy(items.begin() + last, items.end(), items.begin() + first + with.Size());
+	}
+	items.Count = count;
+	std::copy(with.begin(), with.end(), items.begin() + first);
+
+	for (const ListTail& tail : m_Tails)
+		ShiftItems(*tail.Items, tail.From, shift);
+}
+
+// What the leaves of 'item' lag behind, from the shift of its list alone
+int64_t IncrementalParser::Lag(const NodeList& items, uint32_t item) const
+{
+	auto state = m_Lists.find(&items);
+	return state != m_Lists.end() && item >= state->second.ShiftFrom ? state->second.ShiftDelta : 0;
+}
+
+uint32_t IncrementalParser::StatementStart(const NodeList& items, uint32_t item, int64_t lag) const
+{
+	Ref<ASTNode> stmt = items[item];
+	lag += Lag(items, item);
+	if (Ref<NAssignStmt> assign = dynamic_cast<NAssignStmt*>(stmt); assign)
+		return static_cast<uint32_t>(LeafToken(assign->VarIdentifier) + lag);
+	return static_cast<uint32_t>(LeafToken(IfParts(stmt).Condition->Expr1) + lag - 1);
+}
+
+// Follows the last statements nested in the item, ELSE, ENDIF and ';' after them take up a token each
+uint32_t IncrementalParser::StatementEnd(const NodeList& items, uint32_t item, int64_t lag) const
+{
+	Ref<ASTNode> stmt = items[item];
+	lag += Lag(items, item);
+	uint32_t closing = 0;
+	for (;;)
+	{
+		if (Ref<NAssignStmt> assign = dynamic_cast<NAssignStmt*>(stmt); assign)
+			return static_cast<uint32_t>(LeafToken(assign->Expr) + lag + 2 + closing);
+
+		IfParts parts(stmt);
+		closing += 2;
+		const NodeList* nested = &static_cast<NStmtsList*>(parts.Then->StmtsList)->Stmts;
+		if (!parts.Else->Empty)
+		{
+			const NodeList& elseItems = static_cast<NStmtsList*>(parts.Else->StmtsList)->Stmts;
+			if (elseItems.Empty())
+				closing++;
+			else
+				nested = &elseItems;
+		}
+
+		if (nested->Empty())
+			return static_cast<uint32_t>(LeafToken(parts.Condition->Expr2) + lag + 2 + closing);
+		stmt = (*nested)[nested->Size() - 1];
+		lag += Lag(*nested, nested->Size() - 1);
+	}
+}
+
+// Items from 'from' on take in 'delta' more
+void IncrementalParser::ShiftItems(NodeList& items, uint32_t from, int64_t delta)
+{
+	if (delta == 0)
+		return;
+
+	ListState& state = m_Lists[&items];
+	MoveShift(items, state, from);
+	state.ShiftDelta += delta;
+}
+
+// Makes the list's shift start at item 'from' instead, the items in between take it in or drop it
+void IncrementalParser::MoveShift(NodeList& items, ListState& state, uint32_t from)
+{
+	if (state.ShiftDelta != 0)
+	{
+		for (uint32_t i = from; i < std::min(state.ShiftFrom, items.Size()); i++)
+			ShiftLeaves(items[i], -state.ShiftDelta);
+		for (uint32_t i = state.ShiftFrom; i < from; i++)
+			ShiftLeaves(items[i], state.ShiftDelta);
+	}
+	state.ShiftFrom = from;
+}
+
+void IncrementalParser::ShiftLeaves(Ref<ASTNode> root, int64_t delta)
+{
+	if (delta == 0)
+		return;
+
+	m_Shifted.push_back(root);
+	while (!m_Shifted.empty())
+	{
+		Ref<ASTNode> node = m_Shifted.back();
+		m_Shifted.pop_back();
+		if (!node)
+			continue;
+
+		if (node->ChildCount() > 0)
+			AST::ForEachChild(*node, [this](Ref<ASTNode> child) { m_Shifted.push_back(child); });
+		else if (Ref<NIdentifier> identifier = dynamic_cast<NIdentifier*>(node); identifier)
+			identifier->TokenIndex = static_cast<uint32_t>(identifier->TokenIndex + delta);
+		else if (Ref<NConstant> constant = dynamic_cast<NConstant*>(node); constant)
+			constant->TokenIndex = static_cast<uint32_t>(constant->TokenIndex + delta);
+	}
+}
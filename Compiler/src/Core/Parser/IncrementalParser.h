@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Parser.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Keeps the tree of a context up to date with a token stream that an IncrementalLexer edits.
+// Only the items of one list that hold the damaged tokens are parsed again: a declaration or statement, or a run of them,
+// in the innermost THEN or ELSE part that takes in all of the damage. The new items replace the old ones in the same
+// list node, every node outside of them keeps its identity. Where items start is read off the token indices of
+// their leaves, which only a tree without errors has all of; a tree with errors, damage outside of any list
+// or a run that doesn't parse cleanly on its own makes it parse the whole program again.
+// Leaves after the damage are not rewritten: each list keeps a shift that its items from some index on haven't taken in,
+// which is only applied to the items between it and a later edit. SettleLeaves() applies all of them to the tree
+class IncrementalParser
+{
+public:
+	IncrementalParser(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler);
+
+	void Parse();
+	// 'damage' is where the tokens changed since the tree was made, such as IncrementalLexer::LastDamage().
+	// The errors of a tree that has any are reported again, for the text as it is now
+	void Reparse(const TokenDamage& damage);
+	// Brings the token indices of all leaves up to date, has to come before anything else reads them
+	void SettleLeaves();
+
+	uint32_t LastReparsedTokens() const { return m_LastReparsed; }
+
+private:
+	// Items from From on of a list are Delta tokens further than their leaves say.
+	// Capacity is the size of the items array once a graft changed the count, a parsed list has no room to spare
+	struct ListState
+	{
+		uint32_t ShiftFrom = 0;
+		int64_t ShiftDelta = 0;
+		uint32_t Capacity = 0;
+	};
+
+	// Items from From on of a list that follow the damage
+	struct ListTail
+	{
+		NodeList* Items;
+		uint32_t From;
+	};
+
+	bool TryReparse(const TokenDamage& damage);
+	bool ReparseStatements(const TokenDamage& damage, Ref<NStmtsList> list, uint32_t listEnd);
+	bool ReparseDeclarations(const TokenDamage& damage, Ref<NDeclarationsList> list, uint32_t listEnd);
+	void Graft(NodeList& items, uint32_t first, uint32_t last, const NodeList& with, int64_t lag, int64_t shift);
+
+	int64_t Lag(const NodeList& items, uint32_t item) const;
+	uint32_t StatementStart(const NodeList& items, uint32_t item, int64_t lag) const;
+	uint32_t StatementEnd(const NodeList& items, uint32_t item, int64_t lag) const;
+	void ShiftItems(NodeList& items, uint32_t from, int64_t delta);
+	void MoveShift(NodeList& items, ListState& state, uint32_t from);
+	void ShiftLeaves(Ref<ASTNode> root, int64_t delta);
+
+private:
+	std::shared_ptr<CompilationContext> m_Context;
+	std::shared_ptr<ErrorHandler> m_ErrorHandler;
+	Parser m_Parser;
+	std::shared_ptr<ErrorHandler> m_RangeErrors;
+	Parser m_RangeParser;		// Reports to m_RangeErrors, a run that fails is parsed again in full anyway
+
+	bool m_bClean = false;
+	size_t m_ParsedBytes = 0;	// Arena use right after the last full parse
+	uint32_t m_LastReparsed = 0;
+	std::unordered_map<const NodeList*, ListState> m_Lists;
+	std::vector<ListTail> m_Tails;
+	std::vector<Ref<ASTNode>> m_Shifted;
+	std::vector<Ref<ASTNode>> m_Items;
+};
@@ -0,0 +1,114 @@
+#include "ParallelParser.h"
+#include "Parser.h"
+#include "Data/Nodes.h"
+#include "Errors/ErrorHandler.h"
+#include "Utilities/ThreadPool.h"
+
+#include <algorithm>
+#include <future>
+
+static constexpr size_t s_RunsPerThread = 4;
+
+namespace
+{
+	struct ParserRun
+	{
+		std::shared_ptr<CompilationContext> Context;	// Shares the tokens, has an arena of its own
+		std::shared_ptr<ErrorHandler> Errors;
+		Ref<NStmtsList> List = nullptr;
+	};
+}
+
+ParallelParser::ParallelParser(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler)
+	: m_Context(context), m_ErrorHandler(errorHandler)
+{
+}
+
+Ref<ASTNode> ParallelParser::ParseStatements(uint32_t first, uint32_t threadCount)
+{
+	const TokenStream& tokens = *m_Context->Tokens;
+	size_t runCount = std::clamp<size_t>((tokens.Size() - first) / MinRunTokens, 1, threadCount * s_RunsPerThread);
+	std::vector<uint32_t> bounds = SplitIntoRuns(first, runCount);
+	if (bounds.size() < 3)
+		return nullptr;
+	runCount = bounds.size() - 1;
+
+	// Runs locate their errors concurrently, which only reads the line index once it covers the whole source
+	tokens.IndexLines(m_Context->Source->First() + m_Context->Source->Size());
+
+	std::vector<ParserRun> runs(runCount);
+	{
+		ThreadPool pool(threadCount);
+		std::vector<std::future<void>> done;
+		for (size_t i = 0; i < runCount; i++)
+		{
+			done.push_back(pool.Submit([&, i]()
+			{
+				ParserRun& run = runs[i];
+				run.Context = std::make_shared<CompilationContext>();
+				run.Context->Source = m_Context->Source;
+				run.Context->Tokens = m_Context->Tokens;
+				run.Errors = std::make_shared<ErrorHandler>();
+				Parser parser(run.Context, run.Errors);
+				run.List = static_cast<NStmtsList*>(parser.ParseStatementsRange(bounds[i], bounds[i + 1]));
+			}));
+		}
+		for (std::future<void>& task : done)
+			task.get();
+	}
+
+	// A list that stops at a statement it can't parse ends the block's list there, that has to be the last run
+	for (size_t i = 0; i < runCount; i++)
+	{
+		if (!runs[i].List || (!runs[i].List->Complete && i + 1 < runCount))
+			return nullptr;
+	}
+
+	std::vector<Ref<ASTNode>> items;
+	for (ParserRun& run : runs)
+	{
+		items.insert(items.end(), run.List->Stmts.begin(), run.List->Stmts.end());
+		m_Context->Nodes.Adopt(run.Context->Nodes);
+		for (const Error& error : *run.Errors->GetErrors())
+			m_ErrorHandler->ReportError(error);
+	}
+
+	m_ListEnd = bounds.back();
+	uint32_t count = static_cast<uint32_t>(items.size());
+	return AST::MakeStmtsList(m_Context->Nodes, { m_Context->Nodes.Copy(items.data(), count), count }, runs.back().List->Complete);
+}
+
+// Returns run starts followed by the token that ends the list, or nothing when the list doesn't end before Eof.
+// A run ends at the first top-level ';' past its share of the tokens. IF and ENDIF are counted the way the parser pairs them
+// in a program without syntax errors, and any keyword that ends a statements list ends the block's list outside of them
+std::vector<uint32_t> ParallelParser::SplitIntoRuns(uint32_t first, size_t runCount) const
+{
+	const TokenStream& tokens = *m_Context->Tokens;
+	size_t step = (tokens.Size() - first) / runCount;
+
+	std::vector<uint32_t> bounds = { first };
+	uint32_t depth = 0;
+	for (uint32_t i = first; i < tokens.Size() && tokens.Kind(i) != ETokenKind::Eof; i++)
+	{
+		if (tokens.Is(i, ETokenCode::KW_IF))
+		{
+			depth++;
+		}
+		else if (depth == 0 && (tokens.Is(i, ETokenCode::KW_END) || tokens.Is(i, ETokenCode::KW_ELSE) || tokens.Is(i, ETokenCode::KW_ENDIF)))
+		{
+			if (bounds.size() > 1 && bounds.back() == i)
+				bounds.pop_back();
+			bounds.push_back(i);
+			return bounds;
+		}
+		else if (tokens.Is(i, ETokenCode::KW_ENDIF))
+		{
+			depth--;
+		}
+		else if (depth == 0 && tokens.Is(i, ETokenCode::D_Semicolon) && i + 1 - bounds.back() >= step)
+		{
+			bounds.push_back(i + 1);
+		}
+	}
+	return {};
+}
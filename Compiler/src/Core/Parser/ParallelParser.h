@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Data/ASTNode.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct CompilationContext;
+class ErrorHandler;
+
+// Parses the statements list of a large block on a thread pool and joins the results into one list.
+// A scan over the tokens splits the list into runs right after the ';' of statements outside of any IF,
+// each run is parsed on its own up to where the next one starts. Parsed from the top of a list like that,
+// a run makes the same statements and reports the same errors as the sequential parser does for it,
+// so the errors are reported run by run, in source order.
+// A run that doesn't end right where the next one starts means the scan split a statement,
+// which only happens around syntax errors, and the list is left to the sequential parser
+class ParallelParser
+{
+public:
+	static constexpr uint32_t MinTokens = 1 << 20;
+	static constexpr uint32_t MinRunTokens = 1 << 18;
+
+	ParallelParser(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler);
+
+	// The statements list from token 'first' on, nullptr if it has to be parsed sequentially
+	Ref<ASTNode> ParseStatements(uint32_t first, uint32_t threadCount);
+	// Token right after the list ParseStatements() returned
+	uint32_t ListEnd() const { return m_ListEnd; }
+
+private:
+	std::vector<uint32_t> SplitIntoRuns(uint32_t first, size_t runCount) const;
+
+private:
+	std::shared_ptr<CompilationContext> m_Context;
+	std::shared_ptr<ErrorHandler> m_ErrorHandler;
+	uint32_t m_ListEnd = 0;
+};
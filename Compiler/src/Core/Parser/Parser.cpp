@@ -1,30 +1,41 @@
 #include "Parser.h"
+#include "ParallelParser.h"
 #include "Errors/ErrorHandler.h"
 
-Parser::Parser(std::shared_ptr<std::vector<Token>>& tokenSequence, std::shared_ptr<ErrorHandler> errorHandler)
-	: m_ErrorHandler(errorHandler), m_Instigator(EErrorInstigator::Parser), m_TokenSequense(tokenSequence)
+Parser::Parser(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler)
+	: m_ErrorHandler(errorHandler), m_Instigator(EErrorInstigator::Parser), m_Context(context), m_TokenSequense(context->Tokens), m_CurrentToken(0), m_TokenSource(nullptr), m_WindowSize(0)
 {
 }
 
-void Parser::Parse()
+void Parser::Parse(uint32_t threadCount)
 {
-	m_CurrentToken = m_TokenSequense->begin();
-	m_AST = ParseTranslationUnit();
+	m_ThreadCount = threadCount;
+	m_CurrentToken = m_TokenSequense->First();
+	if (m_TokenSource && m_TokenSequense->Empty())
+		Refill();
+	m_Context->Nodes.Clear();
+	m_Context->AST = ParseTranslationUnit();
+}
+
+void Parser::SetTokenSource(TokenSource* source, uint32_t windowSize)
+{
+	m_TokenSource = source;
+	m_WindowSize = windowSize;
 }
 
 Ref<ASTNode> Parser::ParseTranslationUnit()
 {
 	if (IsAtEnd())
-		return AST::MakeSignalProgram(nullptr);
+		return AST::MakeSignalProgram(m_Context->Nodes, nullptr);
 	Ref<ASTNode> program = ParseProgram();
-	return AST::MakeSignalProgram(program);
+	return AST::MakeSignalProgram(m_Context->Nodes, program);
 }
 
 Ref<ASTNode> Parser::ParseProgram()
 {
 	if (!Match(ETokenCode::KW_PROGRAM))
 	{
-		auto error = CreateSyntaxError("'PROGRAM' expected at the start of the translation unit", *Peek());	
+		auto error = CreateSyntaxError("'PROGRAM' expected at the start of the translation unit", TokenAt(Peek()));	
 		m_ErrorHandler->ReportError(error);
 		return nullptr;
 	}
@@ -33,7 +44,7 @@ Ref<ASTNode> Parser::ParseProgram()
 	auto procedureIdentifier = ParseProcedureIdentifier();
 	if (!procedureIdentifier)
 	{
-		auto error = CreateSyntaxError("Missing program name. Expected identifier", *Peek());
+		auto error = CreateSyntaxError("Missing program name. Expected identifier", TokenAt(Peek()));
 		m_ErrorHandler->ReportError(error);
 		Synchronize();
 	}
@@ -42,41 +53,42 @@ Ref<ASTNode> Parser::ParseProgram()
 	auto block = ParseBlock();
 	auto dot = Consume(ETokenCode::D_Dot, "'.' expected at the end of the program.");
 
-	return AST::MakeProgram(program, procedureIdentifier, TokenCode(semicolon), block, TokenCode(dot));
+	return AST::MakeProgram(m_Context->Nodes, program, procedureIdentifier, semicolon, block, dot);
 }
 
 Ref<ASTNode> Parser::ParseBlock()
 {
 	auto varDecl = ParseVariableDeclarations();
 	auto begin = Consume(ETokenCode::KW_BEGIN, "'BEGIN' expected");
-	auto stmtList = ParseStatementsList();
+	auto stmtList = ParseStatementsInParallel();
 	auto end = Consume(ETokenCode::KW_END, "'END' expected");
 
-	return AST::MakeBlock(varDecl, TokenCode(begin), stmtList, TokenCode(end));
+	return AST::MakeBlock(m_Context->Nodes, varDecl, begin, stmtList, end);
 }
 
 Ref<ASTNode> Parser::ParseVariableDeclarations()
 {
 	if (!Match(ETokenCode::KW_VAR))
-		return AST::MakeVariableDeclarations(ETokenCode::Empty, nullptr, true);
+		return AST::MakeVariableDeclarations(m_Context->Nodes, ETokenCode::Empty, nullptr, true);
 	auto var = PreviousCode();
 
 	auto declList = ParseDeclarationsList();
 
-	return AST::MakeVariableDeclarations(var, declList);
+	return AST::MakeVariableDeclarations(m_Context->Nodes, var, declList);
 }
 
 Ref<ASTNode> Parser::ParseDeclarationsList()
 {
-	if (Check(ETokenCode::KW_BEGIN) || IsAtEnd())
-		return AST::MakeDeclarationsList(nullptr, nullptr, true);
-
-	auto decl = ParseDeclaration();	
-	if (!decl)
-		Synchronize();
-	auto declList = ParseDeclarationsList();
+	size_t first = m_ListItems.size();
+	while (!Check(ETokenCode::KW_BEGIN) && !IsAtEnd() && !AtStopToken())
+	{
+		auto decl = ParseDeclaration();
+		if (!decl)
+			Synchronize();
+		m_ListItems.push_back(decl);
+	}
 
-	return AST::MakeDeclarationsList(decl, declList);
+	return AST::MakeDeclarationsList(m_Context->Nodes, TakeListItems(first));
 }
 
 Ref<ASTNode> Parser::ParseDeclaration()
@@ -84,7 +96,7 @@ Ref<ASTNode> Parser::ParseDeclaration()
 	auto varId = ParseVariableIndetifier();
 	if (!varId)
 	{
-		auto error = CreateSyntaxError("Identifier expected at variable declaration or 'BEGIN' is missing", *Peek());
+		auto error = CreateSyntaxError("Identifier expected at variable declaration or 'BEGIN' is missing", TokenAt(Peek()));
 		m_ErrorHandler->ReportError(error);
 		return nullptr;
 	}
@@ -101,63 +113,98 @@ Ref<ASTNode> Parser::ParseDeclaration()
 	if (!IsValid(semicolon))
 		return nullptr;
 
-	return AST::MakeDeclaration(varId, TokenCode(colon), attribute, TokenCode(semicolon));
+	return AST::MakeDeclaration(m_Context->Nodes, varId, colon, attribute, semicolon);
 }
 
 Ref<ASTNode> Parser::ParseAttribute()
 {
 	if (!Match(ETokenCode::KW_INTEGER, ETokenCode::KW_FLOAT))
 	{
-		auto error = CreateSyntaxError("Type specifier expected", *Peek());
+		auto error = CreateSyntaxError("Type specifier expected", TokenAt(Peek()));
 		m_ErrorHandler->ReportError(error);
 		return nullptr;
 	}
 	auto attribute = PreviousCode();
 	
-	return AST::MakeAttribute(attribute);
-}
-
-Ref<ASTNode> Parser::ParseStatementsList()
-{
-	if (Check(ETokenCode::KW_END) || Check(ETokenCode::KW_ELSE) || Check(ETokenCode::KW_ENDIF))
-		return AST::MakeStmtsList(nullptr, nullptr, true);
-
-	auto stmt = ParseStatement();
-	if (!stmt)
-		return nullptr;
-
-	auto stmtList = ParseStatementsList();
-	return AST::MakeStmtsList(stmt, stmtList);
+	return AST::MakeAttribute(m_Context->Nodes, attribute);
 }
 
-Ref<ASTNode> Parser::ParseStatement()
+// Falls back to ParseStatementsList() for small lists and the ones ParallelParser gives up on
+Ref<ASTNode> Parser::ParseStatementsInParallel()
 {
-	auto stmt = ParseIfStatement();
-	if (stmt)
-		return stmt;
-
-	stmt = ParseAssignStatement();	
-	if (!stmt)
-		Synchronize();
-
-	return stmt;
+	if (m_ThreadCount > 1 && !m_TokenSource && m_TokenSequense->Size() - Peek() >= ParallelParser::MinTokens)
+	{
+		ParallelParser parallelParser(m_Context, m_ErrorHandler);
+		if (Ref<ASTNode> stmtList = parallelParser.ParseStatements(Peek(), m_ThreadCount); stmtList)
+		{
+			m_CurrentToken = parallelParser.ListEnd();
+			return stmtList;
+		}
+	}
+	return ParseStatementsList();
 }
 
-Ref<ASTNode> Parser::ParseIfStatement()
+// IF statements nest through statements lists, so the lists inside them are parsed by this loop too.
+// The IFs they belong to wait on m_PendingIfs, nesting is only limited by memory
+Ref<ASTNode> Parser::ParseStatementsList()
 {
-	auto condStmt = ParseConditionStatement();
-	if (!condStmt)
-		return nullptr;
-
-	auto endiff = Consume(ETokenCode::KW_ENDIF, "'ENDIF' expected");
-	if (!IsValid(endiff))
-		return AST::MakeIfStmt(condStmt, ETokenCode::Empty, ETokenCode::Empty);
-
-	auto semicolon = Consume(ETokenCode::D_Semicolon, "';' expected at the end of the if statement");
-	if(!IsValid(semicolon))
-		return AST::MakeIfStmt(condStmt, TokenCode(endiff), ETokenCode::Empty);
+	size_t outer = m_PendingIfs.size();
+	size_t first = m_ListItems.size();
+	for (;;)
+	{
+		bool bComplete = true;
+		bool bNestedList = false;
+		while (!Check(ETokenCode::KW_END) && !Check(ETokenCode::KW_ELSE) && !Check(ETokenCode::KW_ENDIF) && !AtStopToken())
+		{
+			if (Match(ETokenCode::KW_IF))
+			{
+				m_PendingIfs.push_back({ first, PreviousCode() });
+				Ref<ASTNode> ifStmt = ParseIfHeader(m_PendingIfs.back()) ? nullptr : FinishThenPart(nullptr);
+				if (!ifStmt)
+				{
+					bNestedList = true;
+					break;
+				}
+				m_ListItems.push_back(ifStmt);
+				continue;
+			}
+
+			auto stmt = ParseAssignStatement();
+			if (!stmt)
+			{
+				Synchronize();
+				bComplete = false;
+				break;
+			}
+			m_ListItems.push_back(stmt);
+		}
+		if (bNestedList)
+		{
+			first = m_ListItems.size();
+			continue;
+		}
 
-	return AST::MakeIfStmt(condStmt, TokenCode(endiff), TokenCode(semicolon));
+		// Nothing to show for it, same as a failed statement
+		Ref<ASTNode> stmtList = nullptr;
+		if (bComplete || m_ListItems.size() > first)
+			stmtList = AST::MakeStmtsList(m_Context->Nodes, TakeListItems(first), bComplete);
+		if (m_PendingIfs.size() == outer)
+			return stmtList;
+
+		// The list was a part of the innermost pending IF
+		PendingIf& pending = m_PendingIfs.back();
+		size_t enclosingFirst = pending.ListFirst;
+		Ref<ASTNode> ifStmt = pending.IncompleteCondStmt
+			? FinishIfStatement(AST::MakeAlternativePart(m_Context->Nodes, pending.Else, stmtList))
+			: FinishThenPart(stmtList);
+		if (!ifStmt)
+		{
+			first = m_ListItems.size();
+			continue;
+		}
+		first = enclosingFirst;
+		m_ListItems.push_back(ifStmt);
+	}
 }
 
 Ref<ASTNode> Parser::ParseAssignStatement()
@@ -169,68 +216,65 @@ Ref<ASTNode> Parser::ParseAssignStatement()
 	if (!IsValid(assign))
 	{
 		Synchronize();
-		return AST::MakeAssignStmt(varId, ETokenCode::Empty, nullptr, ETokenCode::Empty);
+		return AST::MakeAssignStmt(m_Context->Nodes, varId, ETokenCode::Empty, nullptr, ETokenCode::Empty);
 	}
 
 	auto expr = ParseExpression();
 	if (!expr)
 	{
 		Synchronize();
-		return	AST::MakeAssignStmt(varId, TokenCode(assign), nullptr, ETokenCode::Empty);
+		return	AST::MakeAssignStmt(m_Context->Nodes, varId, assign, nullptr, ETokenCode::Empty);
 	}
 
 	auto semicolon = Consume(ETokenCode::D_Semicolon, "';' expected at the end of the expression");
 	if (!IsValid(semicolon))
-		return	AST::MakeAssignStmt(varId, TokenCode(assign), expr, ETokenCode::Empty);
+		return	AST::MakeAssignStmt(m_Context->Nodes, varId, assign, expr, ETokenCode::Empty);
 
-	return AST::MakeAssignStmt(varId, TokenCode(assign), expr, TokenCode(semicolon));
+	return AST::MakeAssignStmt(m_Context->Nodes, varId, assign, expr, semicolon);
 }
 
-
-Ref<ASTNode> Parser::ParseConditionStatement()
+// Parses the rest of <incomplete-condition-statement> up to its statements list after 'IF'.
+// Returns whether the list follows
+bool Parser::ParseIfHeader(PendingIf& pending)
 {
-	auto condStmt = ParseIncompleteConditionStatement();
-	if (!condStmt)
-		return nullptr;
-
-	auto altPart = ParseAlternativePart();
-	return AST::MakeConditionStmt(condStmt, altPart);
-}
-
-Ref<ASTNode> Parser::ParseIncompleteConditionStatement()
-{
-	if (!Match(ETokenCode::KW_IF))
-		return nullptr;
-
-	auto kwif = PreviousCode();
-	auto condExpr = ParseConditionalExpression();
-	if (!condExpr)
+	pending.CondExpr = ParseConditionalExpression();
+	if (!pending.CondExpr)
 	{
 		Synchronize();
-		return AST::MakeIncompleteConditionStmt(kwif, nullptr, ETokenCode::Empty, nullptr);
+		return false;
 	}
 
-	auto kwthen = Consume(ETokenCode::KW_THEN, "'THEN' expected");
-	if (!IsValid(kwthen))
-		return AST::MakeIncompleteConditionStmt(kwif, condExpr, ETokenCode::Empty, nullptr);
+	pending.Then = Consume(ETokenCode::KW_THEN, "'THEN' expected");
+	return IsValid(pending.Then);
+}
 
-	auto stmtList = ParseStatementsList();
+// Returns the finished IF statement, or nullptr when the statements list of its <alternative-part> follows
+Ref<ASTNode> Parser::FinishThenPart(Ref<ASTNode> stmtList)
+{
+	PendingIf& pending = m_PendingIfs.back();
+	pending.IncompleteCondStmt = AST::MakeIncompleteConditionStmt(m_Context->Nodes, pending.If, pending.CondExpr, pending.Then, stmtList);
+
+	if (!Match(ETokenCode::KW_ELSE))
+		return FinishIfStatement(AST::MakeAlternativePart(m_Context->Nodes, ETokenCode::Empty, nullptr, true));
 
-	return AST::MakeIncompleteConditionStmt(kwif, condExpr, TokenCode(kwthen), stmtList);
+	pending.Else = PreviousCode();
+	return nullptr;
 }
 
-Ref<ASTNode> Parser::ParseAlternativePart()
+Ref<ASTNode> Parser::FinishIfStatement(Ref<ASTNode> altPart)
 {
-	if (!Check(ETokenCode::KW_ELSE))
-		return AST::MakeAlternativePart(ETokenCode::Empty, nullptr, true);
+	auto condStmt = AST::MakeConditionStmt(m_Context->Nodes, m_PendingIfs.back().IncompleteCondStmt, altPart);
+	m_PendingIfs.pop_back();
 
-	if (!Match(ETokenCode::KW_ELSE))
-		return nullptr;
+	auto endiff = Consume(ETokenCode::KW_ENDIF, "'ENDIF' expected");
+	if (!IsValid(endiff))
+		return AST::MakeIfStmt(m_Context->Nodes, condStmt, ETokenCode::Empty, ETokenCode::Empty);
 
-	auto kwelse = PreviousCode();
-	auto stmtList = ParseStatementsList();
+	auto semicolon = Consume(ETokenCode::D_Semicolon, "';' expected at the end of the if statement");
+	if(!IsValid(semicolon))
+		return AST::MakeIfStmt(m_Context->Nodes, condStmt, endiff, ETokenCode::Empty);
 
-	return AST::MakeAlternativePart(kwelse, stmtList);
+	return AST::MakeIfStmt(m_Context->Nodes, condStmt, endiff, semicolon);
 }
 
 Ref<ASTNode> Parser::ParseConditionalExpression()
@@ -253,7 +297,7 @@ Ref<ASTNode> Parser::ParseConditionalExpression()
 		return nullptr;
 	}
 
-	return AST::MakeConditionalExpr(expr1, TokenCode(equal), expr2);
+	return AST::MakeConditionalExpr(m_Context->Nodes, expr1, equal, expr2);
 }
 
 Ref<ASTNode> Parser::ParseExpression()
@@ -270,7 +314,7 @@ Ref<ASTNode> Parser::ParseVariableIndetifier()
 	auto identifier = ParseIdentifier();
 	if (!identifier)
 		return nullptr;
-	return AST::MakeVariableIdentifier(identifier);
+	return AST::MakeVariableIdentifier(m_Context->Nodes, identifier);
 }
 
 Ref<ASTNode> Parser::ParseProcedureIdentifier()
@@ -278,33 +322,51 @@ Ref<ASTNode> Parser::ParseProcedureIdentifier()
 	auto identifier = ParseIdentifier();
 	if (!identifier)
 		return nullptr;
-	return AST::MakeProcedureIdentifier(identifier);
+	return AST::MakeProcedureIdentifier(m_Context->Nodes, identifier);
 }
 
 Ref<ASTNode> Parser::ParseIdentifier()
 {
-	if (!Match(ETokenCode::IdentifierBase))
+	if (!Match(ETokenKind::Identifier))
 		return nullptr;
 
-	auto identifier = Previous()->Code;
-	return AST::MakeIdentifier(identifier, *Peek());
+	auto identifier = m_TokenSequense->Code(Previous());
+	return AST::MakeIdentifier(m_Context->Nodes, identifier, TakeLeafToken());
 }
 
 Ref<ASTNode> Parser::ParseConstant()
 {
-	if (!Match(ETokenCode::ConstantBase))
+	if (!Match(ETokenKind::Constant))
 	{
-		auto error = CreateSyntaxError("Illegal symbol. expression expected", *Peek());
+		auto error = CreateSyntaxError("Illegal symbol. expression expected", TokenAt(Peek()));
 		m_ErrorHandler->ReportError(error);
 		return nullptr;
 	}
-	auto constant = Previous()->Code;
-	return AST::MakeConstant(constant, *Peek());
+	auto constant = m_TokenSequense->Code(Previous());
+	return AST::MakeConstant(m_Context->Nodes, constant, TakeLeafToken());
+}
+
+Ref<ASTNode> Parser::ParseDeclarationsRange(uint32_t first, uint32_t end)
+{
+	m_CurrentToken = first;
+	m_StopToken = end;
+	Ref<ASTNode> list = ParseDeclarationsList();
+	m_StopToken = TokenStream::InvalidIndex;
+	return Peek() == end ? list : nullptr;
+}
+
+Ref<ASTNode> Parser::ParseStatementsRange(uint32_t first, uint32_t end)
+{
+	m_CurrentToken = first;
+	m_StopToken = end;
+	Ref<ASTNode> list = ParseStatementsList();
+	m_StopToken = TokenStream::InvalidIndex;
+	return Peek() == end ? list : nullptr;
 }
 
 Ref<ASTNode> Parser::GetAST()
 {
-	return m_AST;
+	return m_Context->AST;
 }
 
 bool Parser::Match(const ETokenCode& expected)
@@ -318,44 +380,68 @@ bool Parser::Match(const ETokenCode& expected)
 }
 
 
+bool Parser::Match(ETokenKind expected)
+{
+	if (Check(expected))
+	{
+		Advance();
+		return true;
+	}
+	return false;
+}
+
 bool Parser::Check(const ETokenCode& expected)
 {
 	if (IsAtEnd()) return false;
-	if (Peek()->Code >= 501 && Peek()->Code < 1001)
-		return +expected == 501;
-	if (Peek()->Code >= 1001)
-		return +expected == 1001;
-	return Peek()->Code == +expected;
+	return m_TokenSequense->Is(Peek(), expected);
+}
+
+bool Parser::Check(ETokenKind expected)
+{
+	if (IsAtEnd()) return false;
+	return m_TokenSequense->Kind(Peek()) == expected;
 }
 
-std::vector<Token>::iterator Parser::Advance()
+uint32_t Parser::Advance()
 {
 	if (!IsAtEnd()) m_CurrentToken++;
+	if (m_TokenSource && m_CurrentToken == m_TokenSequense->Size())
+		Refill();
 	return Previous();
 }
 
 bool Parser::IsAtEnd()
 {
-	return Peek()->Code == +ETokenCode::Eof;
+	return m_TokenSequense->Kind(Peek()) == ETokenKind::Eof;
 }
 
-std::vector<Token>::iterator Parser::Peek()
+uint32_t Parser::Peek()
 {
 	return m_CurrentToken;
 }
 
-std::vector<Token>::iterator Parser::Previous()
+uint32_t Parser::Previous()
 {
 	return m_CurrentToken - 1;
 }
 
-std::vector<Token>::iterator Parser::Consume(ETokenCode kind, const std::string& message)
+// Lists nested in an IF run past it, they can't end a range
+bool Parser::AtStopToken()
+{
+	return Peek() == m_StopToken && m_PendingIfs.empty();
+}
+
+ETokenCode Parser::Consume(ETokenCode kind, const std::string& message)
 {
-	if (Check(kind)) return Advance();
+	if (Check(kind))
+	{
+		Advance();
+		return kind;
+	}
 
-	auto error = CreateSyntaxError(message, *Peek());
+	auto error = CreateSyntaxError(message, TokenAt(Peek()));
 	m_ErrorHandler->ReportError(error);
-	return m_TokenSequense->end();
+	return ETokenCode::Empty;
 }
 
 void Parser::Synchronize()
@@ -365,9 +451,9 @@ void Parser::Synchronize()
 
 	while (!IsAtEnd())
 	{
-		if (Previous()->Code == +ETokenCode::D_Semicolon) return;
+		if (m_TokenSequense->Is(Previous(), ETokenCode::D_Semicolon)) return;
 
-		switch (Peek()->Code)
+		switch (m_TokenSequense->IsSymbol(Peek()) ? +ETokenCode::None : m_TokenSequense->Code(Peek()))
 		{
 		case +ETokenCode::KW_PROGRAM:
 		case +ETokenCode::KW_VAR:
@@ -386,9 +472,9 @@ void Parser::SynchronizeSafe()
 	Advance();
 	while (!IsAtEnd())
 	{
-		if (Previous()->Code == +ETokenCode::D_Semicolon) return;
+		if (m_TokenSequense->Is(Previous(), ETokenCode::D_Semicolon)) return;
 
-		switch (Peek()->Code)
+		switch (m_TokenSequense->IsSymbol(Peek()) ? +ETokenCode::None : m_TokenSequense->Code(Peek()))
 		{
 		case +ETokenCode::KW_PROGRAM:
 		case +ETokenCode::KW_VAR:
@@ -403,21 +489,44 @@ void Parser::SynchronizeSafe()
 	}
 }
 
-bool Parser::IsValid(std::vector<Token>::iterator it)
+bool Parser::IsValid(ETokenCode code)
 {
-	return it != m_TokenSequense->end();
+	return code != ETokenCode::Empty;
 }
 
-ETokenCode Parser::TokenCode(std::vector<Token>::iterator it)
+ETokenCode Parser::PreviousCode()
 {
-	if (!IsValid(it))
-		return ETokenCode::Empty;
-	return (ETokenCode)it->Code;
+	return (ETokenCode)m_TokenSequense->Code(Previous());
 }
 
-ETokenCode Parser::PreviousCode()
+Token Parser::TokenAt(uint32_t index)
+{
+	return m_TokenSequense->At(index);
+}
+
+// The token a leaf was just made from. A windowed stream drops it before the tree is used, so it is pinned
+uint32_t Parser::TakeLeafToken()
+{
+	if (m_TokenSource)
+		m_TokenSequense->Pin(Previous());
+	return Previous();
+}
+
+// Moves the items pushed since 'first' into the arena. Nested lists push on top of the one they are in
+NodeList Parser::TakeListItems(size_t first)
+{
+	uint32_t count = static_cast<uint32_t>(m_ListItems.size() - first);
+	NodeList list = { m_Context->Nodes.Copy(m_ListItems.data() + first, count), count };
+	m_ListItems.resize(first);
+	return list;
+}
+
+// Nothing looks further back than Previous(), so everything before it can go
+void Parser::Refill()
 {
-	return (ETokenCode)Previous()->Code;
+	if (m_CurrentToken > 0)
+		m_TokenSequense->Compact(m_CurrentToken - 1);
+	m_TokenSource->ScanNext(m_WindowSize);
 }
 
 Error Parser::CreateSyntaxError(const std::string& errorMessage, const Token& token)
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "Data/Token.h"
+#include "Data/TokenStream.h"
 #include "Data/ASTNode.h"
+#include "Data/CompilationContext.h"
 
 #include "Errors/Error.h"
 
@@ -14,9 +16,12 @@ class ErrorHandler;
 class Parser
 {
 public:
-	Parser(std::shared_ptr<std::vector<Token>>& tokenSequence, std::shared_ptr<ErrorHandler> errorHandler);
+	Parser(std::shared_ptr<CompilationContext> context, std::shared_ptr<ErrorHandler> errorHandler);
 
-	void Parse();
+	// The statements of a large block are parsed in parallel when 'threadCount' is above 1
+	void Parse(uint32_t threadCount = 1);
+	// Pull tokens from 'source' on demand, keeping about 'windowSize' of them in the stream
+	void SetTokenSource(TokenSource* source, uint32_t windowSize);
 
 	Ref<ASTNode> ParseTranslationUnit();
 	Ref<ASTNode> ParseProgram();
@@ -26,12 +31,7 @@ public:
 	Ref<ASTNode> ParseDeclaration();
 	Ref<ASTNode> ParseAttribute();
 	Ref<ASTNode> ParseStatementsList();
-	Ref<ASTNode> ParseStatement();
-	Ref<ASTNode> ParseIfStatement();
 	Ref<ASTNode> ParseAssignStatement();
-	Ref<ASTNode> ParseConditionStatement();
-	Ref<ASTNode> ParseIncompleteConditionStatement();
-	Ref<ASTNode> ParseAlternativePart();
 	Ref<ASTNode> ParseConditionalExpression();
 	Ref<ASTNode> ParseExpression();
 	Ref<ASTNode> ParseVariableIndetifier();
@@ -39,10 +39,29 @@ public:
 	Ref<ASTNode> ParseIdentifier();
 	Ref<ASTNode> ParseConstant();
 
+	// Parse the items of a list from tokens [first, end), for reparsing a part of a program.
+	// nullptr unless they end right at 'end'; errors are reported as usual
+	Ref<ASTNode> ParseDeclarationsRange(uint32_t first, uint32_t end);
+	Ref<ASTNode> ParseStatementsRange(uint32_t first, uint32_t end);
+
 	Ref<ASTNode> GetAST();
 
 private:
-
+	// An IF statement whose statements lists are being parsed
+	struct PendingIf
+	{
+		size_t ListFirst;	// Where the items of the list holding the IF start
+		ETokenCode If;
+		Ref<ASTNode> CondExpr = nullptr;
+		ETokenCode Then = ETokenCode::Empty;
+		Ref<ASTNode> IncompleteCondStmt = nullptr;	// Made once the THEN part is done
+		ETokenCode Else = ETokenCode::Empty;
+	};
+
+	Ref<ASTNode> ParseStatementsInParallel();
+	bool ParseIfHeader(PendingIf& pending);
+	Ref<ASTNode> FinishThenPart(Ref<ASTNode> stmtList);
+	Ref<ASTNode> FinishIfStatement(Ref<ASTNode> altPart);
 
 	template <typename... TokenKind>
 	bool Match(const ETokenCode& first, const TokenKind&... tokenKinds)
@@ -54,25 +73,37 @@ private:
 
 	bool Match(const ETokenCode& expected);
 	bool Check(const ETokenCode& expected);
-	std::vector<Token>::iterator Advance();
+	bool Match(ETokenKind expected);
+	bool Check(ETokenKind expected);
+	uint32_t Advance();
 	bool IsAtEnd();
-	std::vector<Token>::iterator Peek();
-	std::vector<Token>::iterator Previous();
-	std::vector<Token>::iterator Consume(ETokenCode kind, const std::string& message);
+	uint32_t Peek();
+	uint32_t Previous();
+	bool AtStopToken();
+	ETokenCode Consume(ETokenCode kind, const std::string& message);
 	void Synchronize();
 	void SynchronizeSafe();
 
-	bool IsValid(std::vector<Token>::iterator);
-	ETokenCode TokenCode(std::vector<Token>::iterator);
+	bool IsValid(ETokenCode code);
 	ETokenCode PreviousCode();
+	Token TokenAt(uint32_t index);
+	uint32_t TakeLeafToken();
+	NodeList TakeListItems(size_t first);
+	void Refill();
 
 private:
 	Error CreateSyntaxError(const std::string& errorMessage, const Token& token);
 
 private:
-	std::shared_ptr<std::vector<Token>> m_TokenSequense;
-	std::vector<Token>::iterator m_CurrentToken;
-	Ref<ASTNode> m_AST;
+	std::shared_ptr<CompilationContext> m_Context;
+	std::shared_ptr<TokenStream> m_TokenSequense;
+	uint32_t m_CurrentToken;
+	TokenSource* m_TokenSource;
+	uint32_t m_WindowSize;
+	uint32_t m_ThreadCount = 1;
+	uint32_t m_StopToken = TokenStream::InvalidIndex;	// The list a range starts in ends there as it does at its closing keyword
+	std::vector<Ref<ASTNode>> m_ListItems;	// Items of the lists being parsed
+	std::vector<PendingIf> m_PendingIfs;
 
 
 	std::shared_ptr<ErrorHandler> m_ErrorHandler;
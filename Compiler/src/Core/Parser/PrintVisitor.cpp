@@ -1,12 +1,17 @@
 #include "PrintVisitor.h"
 
-#include "Data/SymbolTables.h"
+#include "Data/Keywords.h"
 #include "Data/Nodes.h"
 #include "Utilities/Log.h"
 
+AST::PrintVisitor::PrintVisitor(std::shared_ptr<const CompilationContext> context)
+	: m_Context(context)
+{
+}
+
 std::string AST::PrintVisitor::Print(Ref<ASTNode> ast)
 {
-	Ref<NSignalProgram> program = static_pointer_cast<NSignalProgram>(ast);
+	Ref<NSignalProgram> program = static_cast<NSignalProgram*>(ast);
 	if (program)
 	{
 		SafeAcceptPrint(program);
@@ -68,20 +73,19 @@ void AST::PrintVisitor::Visit(NVariableDeclarations& node)
 	EndNode();
 }
 
+// Printed as the right-recursive list of the grammar, every item opens one more level
 void AST::PrintVisitor::Visit(NDeclarationsList& node)
 {
-	StartNode("<declarations-list>");
-
-	if (node.Empty)
+	for (Ref<ASTNode> decl : node.Decls)
 	{
-		PrintEmpty();
-		EndNode();
-		return;
+		StartNode("<declarations-list>");
+		SafeAcceptPrint(decl);
 	}
-	SafeAcceptPrint(node.Decl);
-	SafeAcceptPrint(node.DeclList);
+	StartNode("<declarations-list>");
+	PrintEmpty();
 
-	EndNode();
+	for (uint32_t i = 0; i <= node.Decls.Size(); i++)
+		EndNode();
 }
 
 void AST::PrintVisitor::Visit(NDeclaration& node)
@@ -105,20 +109,27 @@ void AST::PrintVisitor::Visit(NAttribute& node)
 	EndNode();
 }
 
-void AST::PrintVisitor::Visit(NStmtsList& node)
+// Printed as the right-recursive list of the grammar, every item opens one more level
+void AST::PrintVisitor::EnterStmtsListItem(NStmtsList& node, uint32_t index)
 {
 	StartNode("<statements-list>");
+}
 
-	if (node.Empty)
+void AST::PrintVisitor::LeaveStmtsList(NStmtsList& node)
+{
+	if (!node.Complete)
 	{
+		PrintNullptr();
+	}
+	else
+	{
+		StartNode("<statements-list>");
 		PrintEmpty();
 		EndNode();
-		return;
 	}
 
-	SafeAcceptPrint(node.Stmt);
-	SafeAcceptPrint(node.StmtsList);
-	EndNode();
+	for (uint32_t i = 0; i < node.Stmts.Size(); i++)
+		EndNode();
 }
 
 void AST::PrintVisitor::Visit(NStmt& node)
@@ -132,11 +143,13 @@ void AST::PrintVisitor::Visit(NStmt& node)
 
 
 
-void AST::PrintVisitor::Visit(NIfStmt& node)
+void AST::PrintVisitor::EnterIfStmt(NIfStmt& node)
 {
 	StartNode("<if-statement>");
+}
 
-	SafeAcceptPrint(node.CondStmt);
+void AST::PrintVisitor::LeaveIfStmt(NIfStmt& node)
+{
 	PrintAttribute(KeywordToString(node.Endif));
 	PrintAttribute(DelimToString(node.Semicolon));
 
@@ -155,42 +168,42 @@ void AST::PrintVisitor::Visit(NAssignStmt& node)
 	EndNode();
 }
 
-void AST::PrintVisitor::Visit(NConditionStmt& node)
+void AST::PrintVisitor::EnterConditionStmt(NConditionStmt& node)
 {
 	StartNode("<condition-statement>");
+}
 
-	SafeAcceptPrint(node.IncompleteCondStmt);
-	SafeAcceptPrint(node.AltPart);
-
+void AST::PrintVisitor::LeaveConditionStmt(NConditionStmt& node)
+{
 	EndNode();
 }
 
-void AST::PrintVisitor::Visit(NIncompleteConditionStmt& node)
+void AST::PrintVisitor::EnterIncompleteConditionStmt(NIncompleteConditionStmt& node)
 {
 	StartNode("<incomplete-condition-statement>");
 
 	PrintAttribute(KeywordToString(node.If));
 	SafeAcceptPrint(node.CondExpr);
 	PrintAttribute(KeywordToString(node.Then));
-	SafeAcceptPrint(node.StmtsList);
+}
 
+void AST::PrintVisitor::LeaveIncompleteConditionStmt(NIncompleteConditionStmt& node)
+{
 	EndNode();
 }
 
-void AST::PrintVisitor::Visit(NAlternativePart& node)
+void AST::PrintVisitor::EnterAlternativePart(NAlternativePart& node)
 {
 	StartNode("<alternative-part>");
 
 	if (node.Empty)
-	{
 		PrintEmpty();
-		EndNode();
-		return;
-	}
-
-	PrintAttribute(KeywordToString(node.Else));
-	SafeAcceptPrint(node.StmtsList);
+	else
+		PrintAttribute(KeywordToString(node.Else));
+}
 
+void AST::PrintVisitor::LeaveAlternativePart(NAlternativePart& node)
+{
 	EndNode();
 }
 
@@ -283,6 +296,11 @@ void AST::PrintVisitor::EndNode()
 }
 
 
+void AST::PrintVisitor::MissingNode()
+{
+	PrintNullptr();
+}
+
 void AST::PrintVisitor::PrintNullptr()
 {
 	PrintAttribute(std::string(CRIMSON) + "<error-nullptr>" + RESET);
@@ -292,17 +310,19 @@ std::string AST::PrintVisitor::KeywordToString(ETokenCode key)
 {
 	if (key == ETokenCode::Empty)
 		return std::string(LEMON) + "<error-symbol>" + RESET;
-	return TEAL + std::to_string(+key) + RESET + " [" + TEAL + Reverse_KeyWordsTable[+key] + RESET + "]";
+	return TEAL + std::to_string(+key) + RESET + " [" + TEAL + std::string(Keywords::ToString(key)) + RESET + "]";
 }
 
 std::string AST::PrintVisitor::ConstantToString(uint32_t key)
 {
-	return AZURE + std::to_string(key) + RESET + " [" + AZURE + Reverse_ConstantsTable[key] + RESET + "]";
+	std::string value = key < m_Context->Constants.Size() ? std::to_string(m_Context->Constants.Get(key)) : "";
+	return AZURE + std::to_string(+ETokenCode::ConstantBase + key) + RESET + " [" + AZURE + value + RESET + "]";
 }
 
 std::string AST::PrintVisitor::IdentifierToString(uint32_t key)
 {
-	return MAGENTA + std::to_string(key) + RESET + " [" + MAGENTA + Reverse_IdentifiersTable[+key] + RESET + "]";
+	std::string_view name = key < m_Context->Identifiers.Size() ? m_Context->Identifiers.Get(key) : "";
+	return MAGENTA + std::to_string(+ETokenCode::IdentifierBase + key) + RESET + " [" + MAGENTA + std::string(name) + RESET + "]";
 }
 
 std::string AST::PrintVisitor::DelimToString(ETokenCode key)
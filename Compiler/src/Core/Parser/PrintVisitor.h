@@ -1,19 +1,22 @@
 #pragma once
 
-#include "Data/Visitor.h"
+#include "Data/StatementWalker.h"
 #include "Data/Token.h"
 #include "Data/ASTNode.h"
+#include "Data/CompilationContext.h"
 
 #include <sstream>
 #include <string>
 
-#define SafeAcceptPrint(expr) do { if (IsValid(expr.get())) { (expr)->Accept(*this); } else { PrintNullptr(); } } while (false)
+#define SafeAcceptPrint(expr) do { if (IsValid(expr)) { (expr)->Accept(*this); } else { PrintNullptr(); } } while (false)
 
 namespace AST
 {
-	class PrintVisitor : public Visitor
+	class PrintVisitor : public StatementWalker
 	{
 	public:
+		// Symbol names are looked up in 'context'
+		PrintVisitor(std::shared_ptr<const CompilationContext> context);
 
 		std::string Print(Ref<ASTNode> ast);
 
@@ -25,12 +28,7 @@ namespace AST
 		virtual void Visit(NDeclaration& node) override;
 		virtual void Visit(NAttribute& node) override;
 		virtual void Visit(NStmt& node) override;
-		virtual void Visit(NStmtsList& node) override;
-		virtual void Visit(NIfStmt& node) override;
 		virtual void Visit(NAssignStmt& node) override;
-		virtual void Visit(NConditionStmt& node) override;
-		virtual void Visit(NIncompleteConditionStmt& node) override;
-		virtual void Visit(NAlternativePart& node) override;
 		virtual void Visit(NConditionalExpr& node) override;
 		virtual void Visit(NExpr& node) override;
 		virtual void Visit(NVariableIdentifier& node) override;
@@ -38,6 +36,19 @@ namespace AST
 		virtual void Visit(NIdentifier& node) override;
 		virtual void Visit(NConstant& node) override;
 
+	protected:
+		virtual void EnterStmtsListItem(NStmtsList& node, uint32_t index) override;
+		virtual void LeaveStmtsList(NStmtsList& node) override;
+		virtual void EnterIfStmt(NIfStmt& node) override;
+		virtual void LeaveIfStmt(NIfStmt& node) override;
+		virtual void EnterConditionStmt(NConditionStmt& node) override;
+		virtual void LeaveConditionStmt(NConditionStmt& node) override;
+		virtual void EnterIncompleteConditionStmt(NIncompleteConditionStmt& node) override;
+		virtual void LeaveIncompleteConditionStmt(NIncompleteConditionStmt& node) override;
+		virtual void EnterAlternativePart(NAlternativePart& node) override;
+		virtual void LeaveAlternativePart(NAlternativePart& node) override;
+		virtual void MissingNode() override;
+
 	public:
 		void SetDelimeter(const std::string& delim) { m_Delim = delim; }
 	private:
@@ -55,6 +66,7 @@ namespace AST
 		std::string IdentifierToString(uint32_t key);
 		std::string DelimToString(ETokenCode key);
 	private:
+		std::shared_ptr<const CompilationContext> m_Context;
 		std::stringstream m_SS;
 		std::string m_Delim = "-";
 		std::string m_Offset;
@@ -31,7 +31,7 @@ std::string Error::GetPosition()
 	return std::to_string(m_Position);
 }
 
-EErrorInstigator Error::GetEnumInstigator()
+EErrorInstigator Error::GetEnumInstigator() const
 {
 	return m_Instigator;
 }
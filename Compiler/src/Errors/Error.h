@@ -31,7 +31,7 @@ public:
 	std::string GetLine();
 	std::string GetPosition();
 
-	EErrorInstigator GetEnumInstigator();
+	EErrorInstigator GetEnumInstigator() const;
 
 
 private:
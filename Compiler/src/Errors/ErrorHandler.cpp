@@ -3,6 +3,7 @@
 
 #include <sstream>
 #include <memory>
+#include <algorithm>
 
 ErrorHandler::ErrorHandler() : bFatalError(false)
 {
@@ -19,6 +20,14 @@ std::shared_ptr<std::vector<Error>> ErrorHandler::GetErrors()
 	return m_Errors;
 }
 
+void ErrorHandler::SortByInstigator()
+{
+	std::stable_sort(m_Errors->begin(), m_Errors->end(), [](const Error& a, const Error& b)
+		{
+			return a.GetEnumInstigator() < b.GetEnumInstigator();
+		});
+}
+
 Error ErrorHandler::CreateSyntaxError(const std::string& errorMessage, uint32_t line, uint32_t pos, EErrorInstigator instigator)
 {
 	return CreateError(errorMessage, line, pos, instigator, EErrorType::SyntaxError);
@@ -26,16 +35,21 @@ Error ErrorHandler::CreateSyntaxError(const std::string& errorMessage, uint32_t
 
 Error ErrorHandler::CreateSyntaxError(const std::string& errorMessage, const Token& token, EErrorInstigator instigator)
 {
-	if ((ETokenCode)token.Code == ETokenCode::Eof)
+	if (token.Kind == ETokenKind::Eof)
 	{
 		return CreateError("at end; " + errorMessage, token, instigator, EErrorType::SyntaxError);
 	}
 	else
 	{
-		return CreateError("at '" + token.Lexeme + "'; " + errorMessage, token, instigator, EErrorType::SyntaxError );
+		return CreateError("at '" + std::string(token.Lexeme) + "'; " + errorMessage, token, instigator, EErrorType::SyntaxError );
 	}
 }
 
+Error ErrorHandler::CreateSemanticError(const std::string& errorMessage, uint32_t line, uint32_t pos, EErrorInstigator instigator)
+{
+	return CreateError(errorMessage, line, pos, instigator, EErrorType::SemanticError);
+}
+
 Error ErrorHandler::CreateSemanticError(const std::string& errorMessage, const Token& token, EErrorInstigator instigator)
 {
 	return CreateError(errorMessage, token, instigator, EErrorType::SemanticError);
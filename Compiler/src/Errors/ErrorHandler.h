@@ -15,9 +15,12 @@ public:
 
 	void ReportError(Error error);
 	std::shared_ptr<std::vector<Error>> GetErrors();
+	// Stable, keeps the report order within each stage
+	void SortByInstigator();
 
 	static Error CreateSyntaxError(const std::string& errorMessage, uint32_t line, uint32_t pos, EErrorInstigator instigator);
 	static Error CreateSyntaxError(const std::string& errorMessage, const Token& token, EErrorInstigator instigator);
+	static Error CreateSemanticError(const std::string& errorMessage, uint32_t line, uint32_t pos, EErrorInstigator instigator);
 	static Error CreateSemanticError(const std::string& errorMessage, const Token& token, EErrorInstigator instigator);
 	static Error CreateGeneralError(const std::string& errorMessage, EErrorInstigator instigator);
 	static Error CreateBuildError(const std::string& errorMessage, EErrorInstigator instigator);
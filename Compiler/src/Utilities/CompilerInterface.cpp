@@ -1,5 +1,6 @@
 #include "CompilerInterface.h"
 #include "Data/Token.h"
+#include "Data/Keywords.h"
 #include "Log.h"
 
 #include <iostream>
@@ -28,14 +29,23 @@ std::string GetInstigatorColor(EErrorInstigator inst)
 	}
 }
 
+std::vector<std::pair<std::string_view, uint32_t>> GetTableRecords(const StringInterner& table, ETokenCode base)
+{
+	std::vector<std::pair<std::string_view, uint32_t>> records;
+	records.reserve(table.Size());
+	for (uint32_t id = 0; id < table.Size(); id++)
+		records.emplace_back(table.Get(id), +base + id);
+	return records;
+}
+
 void CompilerInterface::SetErrorHandler(std::shared_ptr<ErrorHandler> errorHandler)
 {
 	m_ErrorHandler = errorHandler;
 }
 
-void CompilerInterface::SetLexerData(std::shared_ptr<LexerData> lexerData)
+void CompilerInterface::SetContext(std::shared_ptr<const CompilationContext> context)
 {
-	m_LexerData = lexerData;
+	m_Context = context;
 }
 
 void CompilerInterface::SetInfoFileName(const std::string& fileName)
@@ -117,10 +127,14 @@ void CLI::OutTokens()
 	std::cout << LIME << "============ Token List: ============\n" << RESET;
 	std::cout <<  " Line" <<  "   Pos" << "   Code" << "           Lexeme\n" << std::endl;
 
-	for (const Token& token : *(m_LexerData->Tokens))
+	const TokenStream& tokens = *m_Context->Tokens;
+	if (tokens.First() > 0)
+		std::cout << "  (" << tokens.First() << " earlier tokens were not kept in streaming mode)\n";
+	for (uint32_t i = tokens.First(); i < tokens.Size(); i++)
 	{
-		if (token.Code == +ETokenCode::Eof)
+		if (tokens.Kind(i) == ETokenKind::Eof)
 			break;
+		Token token = tokens.At(i);
 
 		int32_t padding = (lineWidth - std::to_string(token.Line).size()) / 2;
 		std::cout << "|" << TEAL << std::right << std::setw(lineWidth - padding) << token.Line << RESET << std::setw(padding + 1) << "]";
@@ -128,8 +142,8 @@ void CLI::OutTokens()
 		padding = (posWidth - std::to_string(token.Position).size()) / 2;
 		std::cout<< "[" << TEAL << std::setw(posWidth - padding) << token.Position << RESET << std::setw(padding+1) << "]";
 
-		padding = (codeWidth - std::to_string(+token.Code).size()) / 2;
-		std::cout << CRIMSON << std::setw(codeWidth - padding) << +token.Code << RESET << std::setw(padding + 1) << "=";
+		padding = (codeWidth - std::to_string(token.DisplayCode()).size()) / 2;
+		std::cout << CRIMSON << std::setw(codeWidth - padding) << token.DisplayCode() << RESET << std::setw(padding + 1) << "=";
 
 		size_t lex = token.Lexeme.size();
 		padding = (lexemeWidth - lex) / 2;
@@ -143,19 +157,22 @@ void CLI::OutTokens()
 	m_Ofs << "============ Token List: ============\n";
 	m_Ofs << " Line" << "   Pos" << "   Code" << "           Lexeme\n" << std::endl;
 
-	for (const Token& token : *(m_LexerData->Tokens))
+	if (tokens.First() > 0)
+		m_Ofs << "  (" << tokens.First() << " earlier tokens were not kept in streaming mode)\n";
+	for (uint32_t i = tokens.First(); i < tokens.Size(); i++)
 	{
+		Token token = tokens.At(i);
 		int32_t padding = (lineWidth - std::to_string(token.Line).size()) / 2;
 		m_Ofs << "|" << std::right << std::setw(lineWidth - padding) << token.Line << std::setw(padding + 1) << "]";
 
 		padding = (posWidth - std::to_string(token.Position).size()) / 2;
 		m_Ofs << "[" << std::setw(posWidth - padding) << token.Position << std::setw(padding + 1) << "]";
 
-		padding = (codeWidth - std::to_string(+token.Code).size()) / 2;
-		m_Ofs << std::setw(codeWidth - padding) << +token.Code << std::setw(padding + 1) << "=";
+		padding = (codeWidth - std::to_string(token.DisplayCode()).size()) / 2;
+		m_Ofs << std::setw(codeWidth - padding) << token.DisplayCode() << std::setw(padding + 1) << "=";
 
 		padding = (lexemeWidth - token.Lexeme.size()) / 2;
-		m_Ofs << std::setw(lexemeWidth - padding) << std::right << "<" + token.Lexeme + ">" << std::setw(padding + 1) << " " << std::endl;
+		m_Ofs << std::setw(lexemeWidth - padding) << std::right << "<" + std::string(token.Lexeme) + ">" << std::setw(padding + 1) << " " << std::endl;
 	}
 
 	m_Ofs << "=====================================\n\n";
@@ -164,17 +181,30 @@ void CLI::OutTokens()
 
 void CLI::OutIdentifiersTable()
 {
-	DisplayTable(m_LexerData->IdentifiersTable, "Identifiers Table");
+	DisplayTable(GetTableRecords(m_Context->Identifiers, ETokenCode::IdentifierBase), "Identifiers Table");
 }
 
 void CLI::OutConstantsTable()
 {
-	DisplayTable(m_LexerData->ConstantsTable, "Constants Table");
+	const ConstantTable& constants = m_Context->Constants;
+	std::vector<std::string> values;
+	values.reserve(constants.Size());
+	for (uint32_t id = 0; id < constants.Size(); id++)
+		values.push_back(std::to_string(constants.Get(id)));
+
+	std::vector<std::pair<std::string_view, uint32_t>> records;
+	records.reserve(values.size());
+	for (uint32_t id = 0; id < values.size(); id++)
+		records.emplace_back(values[id], +ETokenCode::ConstantBase + id);
+	DisplayTable(records, "Constants Table");
 }
 
 void CLI::OutKeywordsTable()
 {
-	DisplayTable(m_LexerData->KeyWordsTable, "Keywords Table");
+	std::vector<std::pair<std::string_view, uint32_t>> records;
+	for (const auto& keyword : Keywords::List)
+		records.emplace_back(keyword.Lexeme, +keyword.Code);
+	DisplayTable(records, "Keywords Table");
 }
 
 void CLI::OutAST(const std::string& ast)
@@ -207,14 +237,21 @@ void CLI::OutOptions(const std::string& source, const std::string& out)
 void CLI::UsageHint()
 {
 	std::cout << "\nUsage: .\\ssc [options] <source_file> [options]\n";
+	std::cout << "  <source_file>   A .sig file, or - to read the source from stdin\n";
 	std::cout << "Options:\n";
 	std::cout << "  -o <file>       Place the output into <file>\n";
 	std::cout << "  -S              Compile only; do not assemble or link\n";
 	std::cout << "  -v              Verbose mode; show detailed compiler operations\n";
+	std::cout << "  -stream         Lex while parsing; keeps only a small window of tokens in memory\n";
+	std::cout << "  -j <threads>    Threads used to lex and parse large files; defaults to one per core\n";
+	std::cout << "  -dfa            Lex with the table-driven engine instead of the state machine\n";
+	std::cout << "  -cache          Keep the parsed program in <output>.ast and reuse it while the source is unchanged\n";
+	std::cout << "  -edits <file>   Apply the edits in <file> to the source one at a time, relexing and reparsing\n";
+	std::cout << "                  only what each one touches, then compile the result\n";
 	std::cout << "  -h, --help      Display this information\n\n";
 }
 
-void CLI::DisplayTable(const std::unordered_map<std::string, uint32_t>& table, const std::string& tableHeader)
+void CLI::DisplayTable(const std::vector<std::pair<std::string_view, uint32_t>>& table, const std::string& tableHeader)
 {
 	const uint32_t lexemeWidth = 25;
 
@@ -245,7 +282,7 @@ void CLI::DisplayTable(const std::unordered_map<std::string, uint32_t>& table, c
 		m_Ofs << std::left << "|" << std::setw(5) << record.second << "|";
 
 		int32_t padding = (float)(lexemeWidth - record.first.size()) / 2.0;
-		m_Ofs << std::setw(lexemeWidth - padding) << std::right << "<" + record.first + ">" << std::setw(padding) << "|" << std::endl;
+		m_Ofs << std::setw(lexemeWidth - padding) << std::right << "<" + std::string(record.first) + ">" << std::setw(padding) << "|" << std::endl;
 	}
 
 	m_Ofs << "=====================================\n\n";
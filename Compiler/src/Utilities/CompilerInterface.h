@@ -5,6 +5,7 @@
 #include "Log.h"
 
 #include <memory>
+#include <fstream>
 
 
 class CompilerInterface
@@ -25,12 +26,12 @@ public:
 	virtual void UsageHint() = 0;
 
 	void SetErrorHandler(std::shared_ptr<ErrorHandler> errorHandler);
-	void SetLexerData(std::shared_ptr<LexerData> lexerData);
+	void SetContext(std::shared_ptr<const CompilationContext> context);
 	void SetInfoFileName(const std::string& fileName);
 	void SetOutToFileEnabled(bool option);
 protected:
 	std::shared_ptr<ErrorHandler> m_ErrorHandler;
-	std::shared_ptr<LexerData> m_LexerData;
+	std::shared_ptr<const CompilationContext> m_Context;
 
 	std::string m_InfoFileName;
 	bool bOutToFile;
@@ -56,7 +57,7 @@ public:
 	virtual void UsageHint() override;
 
 private:
-	void DisplayTable(const std::unordered_map<std::string, uint32_t>& table, const std::string& tableHeader);
+	void DisplayTable(const std::vector<std::pair<std::string_view, uint32_t>>& table, const std::string& tableHeader);
 	void RemoveColors(std::string& str);
 
 };
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+// Word at a time 64-bit hash, for lookups and for telling files apart. Not meant to resist attacks
+inline uint64_t HashBytes(const void* bytes, size_t size)
+{
+	const char* data = static_cast<const char*>(bytes);
+	uint64_t hash = 0x9E3779B97F4A7C15ull ^ size;
+
+	while (size >= 8)
+	{
+		uint64_t word;
+		std::memcpy(&word, data, 8);
+		hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 32;
+		data += 8;
+		size -= 8;
+	}
+
+	uint64_t tail = 0;
+	if (size > 0)
+		std::memcpy(&tail, data, size);
+	hash = (hash ^ tail) * 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+
+	return hash;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+
+class ThreadPool
+{
+public:
+	explicit ThreadPool(uint32_t threadCount)
+	{
+		for (uint32_t i = 0; i < threadCount; i++)
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			bStopping = true;
+		}
+		m_Wake.notify_all();
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template <typename Function>
+	auto Submit(Function&& function) -> std::future<decltype(function())>
+	{
+		using Result = decltype(function());
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+		std::future<Result> result = task->get_future();
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			m_Tasks.emplace([task]() { (*task)(); });
+		}
+		m_Wake.notify_one();
+		return result;
+	}
+
+	static uint32_t DefaultThreadCount()
+	{
+		uint32_t count = std::thread::hardware_concurrency();
+		return count > 0 ? count : 1;
+	}
+
+private:
+	void WorkerLoop()
+	{
+		for (;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				m_Wake.wait(lock, [this]() { return bStopping || !m_Tasks.empty(); });
+				if (bStopping && m_Tasks.empty())
+					return;
+				task = std::move(m_Tasks.front());
+				m_Tasks.pop();
+			}
+			task();
+		}
+	}
+
+private:
+	std::vector<std::thread> m_Workers;
+	std::queue<std::function<void()>> m_Tasks;
+	std::mutex m_Mutex;
+	std::condition_variable m_Wake;
+	bool bStopping = false;
+};
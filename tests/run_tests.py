@@ -0,0 +1,219 @@
+#!/usr/bin/env python3
+# Runs the compiler over the samples next to this script and checks that alternative paths
+# produce exactly what the default one does.
+# usage: run_tests.py <path to compiler> [check ...]
+import itertools
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+LOG_PREFIX = re.compile(r'^.*\[\d{2}:\d{2}:\d{2}\] ', re.MULTILINE)
+ELAPSED = re.compile(r'^.*Elapsed.*\n?', re.MULTILINE)
+
+
+def samples(*dirs):
+	found = []
+	for name in dirs or sorted(os.listdir(TESTS_DIR)):
+		path = os.path.join(TESTS_DIR, name)
+		if os.path.isdir(path):
+			found += [os.path.join(path, f) for f in sorted(os.listdir(path)) if f.endswith('.sig')]
+	return found
+
+
+class Run:
+	"""Output of one compiler run: stdout without timestamps, comp_info.txt and the listing"""
+	def __init__(self, compiler, source, args, work, listing='out.s'):
+		for leftover in (listing, 'comp_info.txt'):
+			if os.path.exists(os.path.join(work, leftover)):
+				os.remove(os.path.join(work, leftover))
+		result = subprocess.run([compiler, source, '-S', '-o', listing] + args, cwd=work, capture_output=True, text=True, errors='replace')
+		self.ReturnCode = result.returncode
+		self.Stdout = ELAPSED.sub('', LOG_PREFIX.sub('', result.stdout + result.stderr))
+		self.Info = read(os.path.join(work, 'comp_info.txt'))
+		self.Listing = read(os.path.join(work, listing))
+
+	def differences(self, other):
+		return [name for name in ('ReturnCode', 'Stdout', 'Info', 'Listing') if getattr(self, name) != getattr(other, name)]
+
+
+def read(path):
+	if not os.path.exists(path):
+		return None
+	with open(path, 'r', errors='replace') as f:
+		return f.read()
+
+
+def read_bytes(path):
+	with open(path, 'rb') as f:
+		return f.read()
+
+
+def compare(name, expected, actual, failures):
+	diff = expected.differences(actual)
+	if diff:
+		failures.append(f'{name}: {", ".join(diff)} differ')
+
+
+# The table-driven lexer has to produce the same tokens and errors as the state machine
+def check_dfa(compiler, work, failures):
+	for source in samples():
+		name = os.path.relpath(source, TESTS_DIR)
+		compare(f'dfa {name}', Run(compiler, source, ['-v'], work), Run(compiler, source, ['-v', '-dfa'], work), failures)
+
+
+# A second -cache run takes the tree from the image and has to compile the same as a parse.
+# An image that doesn't fit the source, whole and unchanged, is parsed over and written again
+def check_cache(compiler, work, failures):
+	image = os.path.join(work, 'out.ast')
+	for source in samples():
+		name = os.path.relpath(source, TESTS_DIR)
+		if os.path.exists(image):
+			os.remove(image)
+		expected = Run(compiler, source, [], work)
+
+		compare(f'cache {name} (cold)', expected, Run(compiler, source, ['-cache'], work), failures)
+		if not os.path.exists(image):
+			if 'error' not in expected.Stdout.lower():
+				failures.append(f'cache {name}: no image written')
+			continue
+		written = os.stat(image).st_mtime_ns
+		good = read_bytes(image)
+
+		compare(f'cache {name} (warm)', expected, Run(compiler, source, ['-cache'], work), failures)
+		if os.stat(image).st_mtime_ns != written:
+			failures.append(f'cache {name}: image not used')
+
+		damaged = {
+			'truncated': good[:len(good) // 2],
+			'header only': good[:64],
+			'flipped byte': good[:-1] + bytes([good[-1] ^ 0xFF]),
+			'flipped header': bytes([good[0] ^ 0xFF]) + good[1:],
+			'empty': b'',
+		}
+		for damage, content in damaged.items():
+			with open(image, 'wb') as f:
+				f.write(content)
+			compare(f'cache {name} ({damage})', expected, Run(compiler, source, ['-cache'], work), failures)
+			if read_bytes(image) != good:
+				failures.append(f'cache {name} ({damage}): image not written again')
+
+		# The image of the original text, over a copy with the program renamed
+		edited = os.path.join(work, 'edited.sig')
+		with open(edited, 'wb') as f:
+			f.write(re.sub(rb'PROGRAM(\s+)(\w+)', rb'PROGRAM\1\2_edited', read_bytes(source), count=1))
+		expected = Run(compiler, edited, [], work)
+		with open(image, 'wb') as f:
+			f.write(good)
+		compare(f'cache {name} (edited source)', expected, Run(compiler, edited, ['-cache'], work), failures)
+
+
+def apply_edits(text, script):
+	"""The text an -edits script leaves, see Compiler::ReadEditScript() for the format"""
+	escapes = {'n': b'\n', 't': b'\t', '\\': b'\\'}
+	for line in script.splitlines():
+		if not line or line.startswith(b'#'):
+			continue
+		offset, removed, inserted = (line.split(b' ', 2) + [b''])[:3]
+		inserted = re.sub(rb'\\(.)', lambda m: escapes[m.group(1).decode()], inserted)
+		offset = int(offset)
+		text = text[:offset] + inserted + text[offset + int(removed):]
+	return text
+
+
+# Editing a program one edit at a time with -edits has to compile the same as the text it ends up with.
+# Symbol tables only grow while editing, so their ids aren't compared, but the listing and the errors are
+def check_incremental(compiler, work, failures):
+	for source in samples('incremental'):
+		name = os.path.relpath(source, TESTS_DIR)
+		script = os.path.splitext(source)[0] + '.edits'
+		if not os.path.exists(script):
+			continue
+
+		# Same file name in both runs, the output names the source
+		original, edited = os.path.join(work, 'original'), os.path.join(work, 'edited')
+		for directory, content in ((original, read_bytes(source)), (edited, apply_edits(read_bytes(source), read_bytes(script)))):
+			os.makedirs(directory, exist_ok=True)
+			with open(os.path.join(directory, os.path.basename(source)), 'wb') as f:
+				f.write(content)
+		expected = Run(compiler, os.path.basename(source), [], edited)
+		compare(f'incremental {name}', expected, Run(compiler, os.path.basename(source), ['-edits', script], original), failures)
+
+
+def large_program(tokens, inserted):
+	"""A program of about 'tokens' tokens in one statements list, with each of 'inserted' put in at its share of them"""
+	lines = ['PROGRAM parallel;', 'VAR a:INTEGER; b:INTEGER; c:FLOAT;', 'BEGIN']
+	statements = [
+		('\ta := {};', 4),
+		('\tIF a = {} THEN b := a; ELSE IF b = c THEN c := 1; ENDIF; ENDIF;', 21),
+		('\tIF b = a\n\tTHEN\n\t\tc := b;\n\t\tb := {};\n\tENDIF;', 14),
+	]
+	inserted = sorted(inserted)
+	count = 0
+	for i in itertools.count():
+		if count >= tokens:
+			break
+		text, length = statements[i % len(statements)]
+		lines.append(text.format(i))
+		count += length
+		while inserted and count >= tokens * inserted[0][0]:
+			lines.append(inserted.pop(0)[1])
+	lines.append('END.')
+	return '\n'.join(lines) + '\n'
+
+
+# Sources above ParallelLexer::MinSourceSize with lists above ParallelParser::MinTokens are lexed and parsed
+# in runs with -j above 1, which has to compile exactly the same as one thread does
+def check_parallel(compiler, work, failures):
+	tokens = 1400000
+	programs = {
+		'no errors': [],
+		# Runs that parse to their end with errors, the errors are merged in run order
+		'errors in runs': [(0.3, '\ta := ;'), (0.5, '\tb := 12abc;'), (0.7, '\tIF a THEN b := 1; ENDIF;')],
+		# A run that stops at a statement it can't parse, the whole list is parsed again on one thread
+		'run stopped': [(0.5, '\ta := 1 2;')],
+		# An IF that isn't closed leaves nothing to split at
+		'unclosed IF': [(0.5, '\tIF a = 1 THEN b := 1;')],
+	}
+	source = os.path.join(work, 'parallel.sig')
+	for name, inserted in programs.items():
+		with open(source, 'w') as f:
+			f.write(large_program(tokens, inserted))
+		compare(f'parallel ({name})', Run(compiler, source, ['-j', '1'], work), Run(compiler, source, ['-j', '4'], work), failures)
+
+
+CHECKS = {
+	'dfa': check_dfa,
+	'cache': check_cache,
+	'incremental': check_incremental,
+	'parallel': check_parallel,
+}
+
+
+def main():
+	if len(sys.argv) < 2:
+		print(f'usage: {sys.argv[0]} <path to compiler> [{" ".join(CHECKS)}]')
+		return 2
+	compiler = os.path.abspath(sys.argv[1])
+	selected = sys.argv[2:] or list(CHECKS)
+
+	failures = []
+	work = tempfile.mkdtemp(prefix='ssc_tests_')
+	try:
+		for check in selected:
+			before = len(failures)
+			CHECKS[check](compiler, work, failures)
+			print(f'{check}: {"ok" if len(failures) == before else "FAILED"}')
+	finally:
+		shutil.rmtree(work, ignore_errors=True)
+
+	for failure in failures:
+		print(failure)
+	return 1 if failures else 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())